@@ -0,0 +1,39 @@
+# Try to find DepQBF headers and libraries.
+#
+# Usage of this module as follows:
+#
+# find_package(depqbf)
+#
+# Variables used by this module, they can change the default behaviour and need
+# to be set before calling find_package:
+#
+# DEPQBF_ROOT Set this variable to the root installation of
+# DepQBF if the module has problems finding the
+# proper installation path.
+#
+# Variables defined by this module:
+#
+# DEPQBF_FOUND System has DepQBF libraries and headers
+# DEPQBF_LIBRARIES The DepQBF library
+# DEPQBF_INCLUDE_DIRS The location of DepQBF headers
+
+# Get hint from environment variable (if any)
+if(NOT DEPQBF_ROOT AND DEFINED ENV{DEPQBF_ROOT})
+    set(DEPQBF_ROOT "$ENV{DEPQBF_ROOT}" CACHE PATH "DepQBF base directory location (optional, used for nonstandard installation paths)")
+    mark_as_advanced(DEPQBF_ROOT)
+endif()
+
+# Search path for nonstandard locations
+if(DEPQBF_ROOT)
+    set(DEPQBF_INCLUDE_PATH PATHS "${DEPQBF_ROOT}/include" "${DEPQBF_ROOT}" NO_DEFAULT_PATH)
+    set(DEPQBF_LIBRARY_PATH PATHS "${DEPQBF_ROOT}/lib" "${DEPQBF_ROOT}" NO_DEFAULT_PATH)
+endif()
+
+find_path(DEPQBF_INCLUDE_DIRS NAMES qdpll.h HINTS ${DEPQBF_INCLUDE_PATH})
+find_library(DEPQBF_LIBRARIES NAMES qdpll HINTS ${DEPQBF_LIBRARY_PATH})
+
+include(FindPackageHandleStandardArgs)
+
+find_package_handle_standard_args(depqbf DEFAULT_MSG DEPQBF_LIBRARIES DEPQBF_INCLUDE_DIRS)
+
+mark_as_advanced(DEPQBF_ROOT DEPQBF_LIBRARIES DEPQBF_INCLUDE_DIRS)
@@ -0,0 +1,120 @@
+//
+// Synthetico - Pure-past LTL synthesizer based on BLACK
+//
+// (C) 2023 Nicola Gigante
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef SYNTH_AIG_HPP
+#define SYNTH_AIG_HPP
+
+#include "synthetico/common.hpp"
+#include "synthetico/qbf.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace synth {
+
+  //
+  // An and-inverter graph. Nodes are stored in a flat array and referred to
+  // by edges, i.e. twice the index of the node, plus one if the edge is
+  // negated. Node 0 is the constant false, so edges 0 and 1 are false and
+  // true. Identical gates are built only once, and gates are simplified on
+  // construction by constant propagation and by the two-level rules of 
+  // Brummayer and Biere (contradiction, idempotence, subsumption and 
+  // substitution).
+  //
+  class aig {
+  public:
+    using edge = uint32_t;
+
+    static constexpr edge bottom = 0;
+    static constexpr edge top = 1;
+
+    static edge negate(edge e) { return e ^ 1; }
+    static bool negated(edge e) { return e & 1; }
+    static size_t node(edge e) { return e >> 1; }
+
+    aig() = default;
+
+    // a fresh input node
+    edge input();
+
+    edge land(edge a, edge b);
+    edge lor(edge a, edge b) { return negate(land(negate(a), negate(b))); }
+    edge implies(edge a, edge b) { return lor(negate(a), b); }
+    edge iff(edge a, edge b) { return land(implies(a, b), implies(b, a)); }
+
+    size_t size() const { return _nodes.size(); }
+    bool is_input(size_t n) const { return n > 0 && _nodes[n].left == 0; }
+    bool is_gate(size_t n) const { return _nodes[n].left != 0; }
+    edge left(size_t n) const { return _nodes[n].left; }
+    edge right(size_t n) const { return _nodes[n].right; }
+
+    //
+    // Copies into this graph the cone of `e` in graph `g`. `map` is indexed 
+    // by the nodes of `g`, and must give the edge standing for each input 
+    // of the cone. Gates are added to it as they are copied, so a map can be
+    // reused to copy many cones at once.
+    //
+    edge copy(aig const& g, edge e, std::unordered_map<size_t, edge> &map);
+
+  private:
+    struct node_t {
+      edge left = 0;
+      edge right = 0;
+    };
+
+    edge make_and(edge a, edge b);
+
+    std::vector<node_t> _nodes = {node_t{}};
+    std::unordered_map<uint64_t, edge> _gates;
+  };
+
+  //
+  // Builds the graph of a Boolean formula, whose propositions stand for the 
+  // edges given by `inputs`.
+  //
+  aig::edge to_aig(
+    aig &g, bformula f, std::function<aig::edge(proposition)> const& inputs
+  );
+
+  //
+  // Appends to `out` the CNF asserting the given edges. `vars` is indexed by
+  // nodes and must give the variable of each input reached, while the gates
+  // that need one get a fresh variable, starting from `next`. With the
+  // `polarity` clausifier, gates are only constrained in the direction 
+  // needed by the polarity of their occurrences. In any case, chains of 
+  // gates get a single variable, and top-level conjunctions and disjunctions
+  // get none.
+  //
+  void clausify(
+    aig const& g, std::span<aig::edge const> roots, clausifier_t clausifier,
+    std::vector<var_t> &vars, var_t &next, clause_list &out
+  );
+
+}
+
+#endif // SYNTH_AIG_HPP
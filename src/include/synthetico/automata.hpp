@@ -28,6 +28,7 @@
 #include <black/logic/logic.hpp>
 
 #include "synthetico.hpp"
+#include "aig.hpp"
 
 namespace synth {
   
@@ -47,6 +48,29 @@ namespace synth {
 
   automata encode(spec sp);
 
+  //
+  // The transition relation is a conjunction of definitions of the primed
+  // state variables, and the initial condition a conjunction of literals.
+  // These give the next value of each state variable as a function of the 
+  // current state and moves, and the value of each one at the start.
+  //
+  std::vector<bformula> next_state(automata const& aut);
+  std::vector<bool> initial_state(automata const& aut);
+
+  //
+  // The automaton as an and-inverter graph, whose input nodes are, in order,
+  // the state variables, the inputs, the outputs and the primed state 
+  // variables.
+  //
+  struct automata_aig {
+    aig graph;
+    aig::edge init;
+    aig::edge trans;
+    aig::edge objective;
+  };
+
+  automata_aig to_aig(automata const& aut);
+
 }
 
 #endif // SYNTH_AUTOMATA_HPP
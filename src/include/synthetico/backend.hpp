@@ -27,15 +27,128 @@
 
 #include <black/support/tribool.hpp>
 
+#include <optional>
+#include <span>
+#include <string>
+
+struct QDPLL;
+
 namespace synth {
 
+  //
+  // The solvers we can use to decide QDIMACS queries. Some of them are
+  // external programs that we launch for each query, while others are
+  // libraries linked into our own process, which take the query directly
+  // from memory in a forked child. The latter are available only if found at
+  // build time.
+  //
   enum class backend_t {
     pedant,
-    dqbdd
+    dqbdd,
+    depqbf
+  };
+
+  std::string to_string(backend_t backend);
+  std::optional<backend_t> to_backend(std::string const& name);
+
+  bool is_external(backend_t backend);
+  bool is_available(backend_t backend);
+
+  //
+  // A query solved in the background by a backend process, either running
+  // an external program or forked from our own. Dropping the object stops 
+  // the backend if it is still running. A query running out of the given
+  // limits is undefined.
+  // If a cache is given, it is looked up before launching the backend and
+  // filled with the backend's definitive answers.
+  //
+  class query {
+  public:
+    query(
+      qdimacs const& qd, backend_t backend, 
+      limits_t limits = {}, cache const *results = nullptr
+    );
+
+    // a query already answered in some other way
+    explicit query(black::tribool result) : _result{result} { }
+
+    // whether the answer is available without blocking
+    bool done() const;
+
+    // the size in bytes of the query as sent to the backend, or zero if it
+    // was answered without sending it anywhere
+    size_t size() const { return _size; }
+
+    // blocks until the backend answers
+    black::tribool result();
+
+    // stops the backend, whose result becomes undefined if not known yet
+    void cancel();
+
+    // blocks until one of the given queries is answered, and returns its
+    // index, or queries.size() if all of them are null
+    static size_t wait_any(std::span<query * const> queries);
+
+    // stops the backends of all the given queries at once, null ones aside
+    static void cancel_all(std::span<query * const> queries);
+
+  private:
+    void record(black::tribool result);
+
+    backend_t _backend = backend_t::pedant;
+    cache const *_cache = nullptr;
+    std::string _key;
+    size_t _size = 0;
+    std::optional<process> _process;
+    std::optional<black::tribool> _result;
+  };
+
+  //
+  // A backend kept alive across a sequence of queries, each extending the 
+  // previous one, so that what it learned is retained. Blocks are only 
+  // appended at the innermost end of the prefix, and clauses are never 
+  // removed: queries differ by clauses guarded by selector variables of the
+  // outermost block, which must be existential, and which are switched on 
+  // by assuming them. Only `depqbf` supports this.
+  //
+  class incremental_solver {
+  public:
+    explicit incremental_solver(backend_t backend);
+    ~incremental_solver();
+
+    incremental_solver(incremental_solver const&) = delete;
+    incremental_solver &operator=(incremental_solver const&) = delete;
+
+    static bool is_supported(backend_t backend);
+
+    // appends the block to the prefix, merging it with the innermost block
+    // if they have the same type
+    void add(qdimacs_block const& block);
+
+    // adds a variable to the outermost block
+    void add_outermost(var_t var);
+
+    void add(clause cl);
+
+    // whether the clauses added so far are true under the given literals
+    black::tribool solve(std::span<lit_t const> assumptions = {});
+
+  private:
+    void declare(var_t var);
+
+    [[maybe_unused]] QDPLL *_solver = nullptr;
+    decltype(qdimacs_block::type) _innermost = qdimacs_block::existential;
+    unsigned _nesting = 0;
+    var_t _n_vars = 0;
   };
 
-  black::tribool is_sat(qdimacs const& qd);
-  black::tribool is_sat(qbformula f);
+  black::tribool is_sat(
+    qdimacs const& qd, 
+    backend_t backend = backend_t::pedant, limits_t limits = {}, 
+    cache const *results = nullptr
+  );
+  
+  black::tribool is_sat(qbformula f, backend_t backend = backend_t::pedant);
 
 }
 
@@ -0,0 +1,60 @@
+//
+// Synthetico - Pure-past LTL synthesizer based on BLACK
+//
+// (C) 2023 Nicola Gigante
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef SYNTH_CACHE_HPP
+#define SYNTH_CACHE_HPP
+
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace synth {
+
+  //
+  // A persistent cache of query results, stored as one small file per query
+  // in the given directory. Queries are identified by a hash of their
+  // normalized contents, i.e. the quantifier prefix and the sorted clauses,
+  // so that equal formulas hit the same entry regardless of clause order.
+  // Entries are accessed under file locks, so concurrent runs can safely
+  // share the same directory.
+  //
+  class cache {
+  public:
+    explicit cache(std::filesystem::path dir);
+
+    static std::string key(qdimacs const& qd);
+
+    std::optional<bool> lookup(std::string const& key) const;
+    void store(std::string const& key, bool sat) const;
+
+  private:
+    std::filesystem::path entry(std::string const& key) const;
+
+    std::filesystem::path _dir;
+  };
+
+}
+
+#endif // SYNTH_CACHE_HPP
@@ -0,0 +1,77 @@
+//
+// Synthetico - Pure-past LTL synthesizer based on BLACK
+//
+// (C) 2023 Nicola Gigante
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef SYNTH_GAME_CEGAR_HPP
+#define SYNTH_GAME_CEGAR_HPP
+
+#include "synthetico/synthetico.hpp"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace synth {
+
+  //
+  // Decides the bounded games of the QBF search in our own process, by 
+  // counterexample-guided abstraction refinement on BLACK's SAT backends 
+  // (the RAReQS algorithm of Janota et al.). The query of each player is 
+  // seen as a game of the player choosing the outputs against the one 
+  // choosing the inputs, one step after the other. A player looks for a 
+  // move winning against the counter-moves found so far, and the opponent 
+  // looks for a counter-move refuting it, in turn by the same procedure. 
+  // Games with two moves left are solved by two incremental SAT solvers, 
+  // one proposing candidate moves and the other refuting them.
+  //
+  // The counter-moves found at each position of the game are kept across 
+  // bounds, since positions reached by the same moves exist at any larger 
+  // bound, and refine the abstraction from the start when the position is 
+  // reached again.
+  //
+  class cegar {
+  public:
+    cegar(automata aut, game_t type, lasso_t lasso, logic::alphabet &sigma);
+
+    // the answers to the queries of the controller and of the environment
+    // at bound n
+    std::array<black::tribool, 2> solve(size_t n);
+
+    struct refutations;
+
+  private:
+    automata _aut;
+    game_t _type;
+    lasso_t _lasso;
+    logic::alphabet *_sigma;
+    std::vector<bformula> _next; // the next value of each state variable
+    std::vector<bool> _init; // the initial value of each state variable
+
+    // the counter-moves learned in the game of each player
+    std::array<std::shared_ptr<refutations>, 2> _learned;
+  };
+
+}
+
+#endif // SYNTH_GAME_CEGAR_HPP
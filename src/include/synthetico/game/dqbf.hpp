@@ -0,0 +1,46 @@
+//
+// Synthetico - Pure-past LTL synthesizer based on BLACK
+//
+// (C) 2023 Nicola Gigante
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef SYNTH_GAME_DQBF_HPP
+#define SYNTH_GAME_DQBF_HPP
+
+#include "synthetico/synthetico.hpp"
+
+namespace synth {
+
+  //
+  // Decides realizability with a single DQBF query stating the existence of
+  // a controller whose outputs only depend on the current state of the 
+  // automaton, which suffices since the automaton is deterministic, and of 
+  // an inductive winning region containing the initial states. For `F` 
+  // games, a ranking of the states in the region must also decrease at each
+  // step until the objective is met. The size of the query does not depend 
+  // on any bound.
+  //
+  black::tribool is_realizable_dqbf(spec sp, qbf_options const& opts = {});
+
+}
+
+#endif // SYNTH_GAME_DQBF_HPP
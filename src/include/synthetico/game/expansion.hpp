@@ -0,0 +1,67 @@
+//
+// Synthetico - Pure-past LTL synthesizer based on BLACK
+//
+// (C) 2023 Nicola Gigante
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef SYNTH_GAME_EXPANSION_HPP
+#define SYNTH_GAME_EXPANSION_HPP
+
+#include "synthetico/synthetico.hpp"
+
+#include <array>
+#include <vector>
+
+namespace synth {
+
+  //
+  // Decides the bounded games of the QBF search in a SAT solver running in 
+  // our own process, by expanding the quantifiers over the inputs. Each 
+  // history of inputs up to the bound gets its own copy of the outputs, and 
+  // histories with a common prefix share the copies along it, so the 
+  // instance has about 2^(|inputs| * n) copies of the transition relation.
+  // The states are computed from the outputs and the (constant) inputs, so 
+  // the copies are simplified and shared as much as possible. The query of 
+  // the environment is answered by asking whether the controller can avoid
+  // the environment's winning condition along all the histories.
+  //
+  class expansion {
+  public:
+    expansion(
+      automata aut, game_t type, lasso_t lasso, logic::alphabet &sigma
+    );
+
+    // the answers to the queries of the controller and of the environment
+    // at bound n
+    std::array<black::tribool, 2> solve(size_t n);
+
+  private:
+    automata _aut;
+    game_t _type;
+    lasso_t _lasso;
+    logic::alphabet *_sigma;
+    std::vector<bformula> _next; // the next value of each state variable
+  };
+
+}
+
+#endif // SYNTH_GAME_EXPANSION_HPP
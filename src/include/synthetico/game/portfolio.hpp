@@ -0,0 +1,49 @@
+//
+// Synthetico - Pure-past LTL synthesizer based on BLACK
+//
+// (C) 2023 Nicola Gigante
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef SYNTH_GAME_PORTFOLIO_HPP
+#define SYNTH_GAME_PORTFOLIO_HPP
+
+#include "synthetico/synthetico.hpp"
+
+#include <string>
+
+namespace synth {
+
+  struct portfolio_result {
+    black::tribool realizable = black::tribool::undef;
+    std::string engine; // the engine that answered first, if any
+  };
+
+  //
+  // Runs all the available algorithms at the same time, each in its own
+  // process, and returns the first definitive answer.
+  //
+  portfolio_result 
+  is_realizable_portfolio(spec sp, qbf_options const& opts = {});
+
+}
+
+#endif // SYNTH_GAME_PORTFOLIO_HPP
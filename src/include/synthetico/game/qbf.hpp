@@ -29,7 +29,122 @@
 
 namespace synth {
 
-  black::tribool is_realizable_qbf(spec sp);
+  //
+  // How the unrolling bound is increased. The `linear` search tries bounds
+  // in order from the starting one (see `starting_bound`), possibly with many
+  // of them in flight at once (see `window`), while the `gallop` search 
+  // doubles the bound until some player wins, and then possibly bisects back
+  // to the smallest winning bound.
+  //
+  enum class search_t {
+    linear,
+    gallop
+  };
+
+  std::string to_string(search_t strategy);
+  std::optional<search_t> to_search(std::string const& name);
+
+  //
+  // How safety games detect that a play can go on forever. The `pairwise` 
+  // encoding looks for two steps with the same inputs and outputs, so its 
+  // size is quadratic in the bound. The `compact` one guesses the state where
+  // the play loops and compares each step only with it, so its size is 
+  // linear in the bound.
+  //
+  enum class lasso_t {
+    pairwise,
+    compact
+  };
+
+  std::string to_string(lasso_t lasso);
+  std::optional<lasso_t> to_lasso(std::string const& name);
+
+  //
+  // What the queries state. The `unrolling` encoding asks, for increasing 
+  // bounds, whether either player wins within the bound. The `positional` 
+  // one asks in a single DQBF query for a controller whose outputs only 
+  // depend on the current state, together with an inductive winning region
+  // (see `is_realizable_dqbf`).
+  //
+  enum class encoding_t {
+    unrolling,
+    positional
+  };
+
+  std::string to_string(encoding_t encoding);
+  std::optional<encoding_t> to_encoding(std::string const& name);
+
+  //
+  // How the completeness threshold of the search is computed (see 
+  // `completeness_threshold`). The `structural` one only looks at the number
+  // of variables of the automaton, while the `reachable` one counts its 
+  // reachable states with BDDs, which is tighter but might be costly.
+  //
+  enum class threshold_t {
+    structural,
+    reachable
+  };
+
+  std::string to_string(threshold_t threshold);
+  std::optional<threshold_t> to_threshold(std::string const& name);
+
+  struct qbf_options {
+    backend_t backend = backend_t::pedant;
+
+    encoding_t encoding = encoding_t::unrolling;
+    
+    // resources granted to each backend query
+    limits_t limits;
+
+    // wall-clock budget for the whole search
+    std::optional<std::chrono::milliseconds> timeout;
+
+    // directory of the persistent cache of query results, if any
+    std::optional<std::filesystem::path> cache_dir;
+
+    search_t search = search_t::linear;
+
+    // how the bound past which the search does not go is computed
+    threshold_t threshold = threshold_t::structural;
+
+    // the first bound tried, e.g. the decisive one of an earlier run, instead
+    // of the one guessed from the specification (see `starting_bound`)
+    std::optional<size_t> start;
+
+    // number of consecutive bounds whose queries run concurrently, in the 
+    // linear search
+    size_t window = 1;
+
+    // number of bounds whose queries are encoded in the background while
+    // earlier ones are solved, in the linear search, or 0 for none
+    size_t lookahead = 2;
+
+    // whether the gallop search bisects back to the smallest winning bound
+    bool minimal = false;
+
+    // how the unrolling and the winning conditions are turned into CNF
+    clausifier_t clausifier = clausifier_t::tseitin;
+
+    // how lassos are encoded in safety games
+    lasso_t lasso = lasso_t::pairwise;
+
+    // bounds n with |inputs| * n below this are decided by expansion in a 
+    // SAT solver (see `expansion`), if BLACK has any SAT backend
+    size_t expand = 12;
+
+    // whether the bounds not expanded are decided in-process by abstraction
+    // refinement (see `cegar`) instead of by the backend
+    bool cegar = false;
+
+    // whether queries are simplified in-process before reaching the backend
+    bool preprocess = false;
+
+    // whether each player's queries are solved by a single backend instance
+    // across bounds (see `incremental_solver`), which needs `depqbf`
+    bool incremental = false;
+  };
+
+  black::tribool is_realizable_qbf(spec sp, qbf_options const& opts = {});
 
 }
 
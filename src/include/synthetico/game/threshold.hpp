@@ -0,0 +1,65 @@
+//
+// Synthetico - Pure-past LTL synthesizer based on BLACK
+//
+// (C) 2023 Nicola Gigante
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef SYNTH_GAME_THRESHOLD_HPP
+#define SYNTH_GAME_THRESHOLD_HPP
+
+#include "synthetico/synthetico.hpp"
+
+#include <optional>
+
+namespace synth {
+
+  //
+  // A bound at which some player is guaranteed to win the bounded game, so
+  // that the search never has to go past it. Winning is monotone in the 
+  // bound, and the winner of the infinite game wins it with a memoryless 
+  // strategy over the states of the automaton. Then the reachability player
+  // meets its objective within R - 1 steps, where R bounds the number of
+  // reachable states, while the safety player closes a lasso as soon as the
+  // play repeats a state (compact lassos, within R steps) or a move 
+  // (pairwise lassos, within 2^(|inputs| + |outputs|) + 1 steps). The 
+  // `structural` threshold takes R = 2^|variables|, and the `reachable` one
+  // counts the reachable states with BDDs. The result is empty if the 
+  // threshold does not fit in a size_t.
+  //
+  std::optional<size_t> 
+  completeness_threshold(automata const& aut, lasso_t lasso, threshold_t kind);
+
+  //
+  // The first bound worth trying. The reachability player (the controller in
+  // `eventually` games, the environment in `always` ones) needs its target 
+  // to hold at some step, which cannot happen before the chains of `Y` 
+  // operators it requires have been walked through, so it cannot win at
+  // smaller bounds. These can then only be decided by the safety player, 
+  // whose wins persist at larger bounds, so skipping them never changes the
+  // answer, although it might not be given at the smallest decisive bound.
+  // The result is never below 3.
+  //
+  size_t starting_bound(spec sp);
+
+}
+
+#endif // SYNTH_GAME_THRESHOLD_HPP
@@ -0,0 +1,82 @@
+//
+// Synthetico - Pure-past LTL synthesizer based on BLACK
+//
+// (C) 2023 Nicola Gigante
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef SYNTH_PREPROCESS_HPP
+#define SYNTH_PREPROCESS_HPP
+
+#include "synthetico/qbf.hpp"
+
+#include <cstddef>
+#include <iosfwd>
+#include <stop_token>
+
+namespace synth {
+
+  //
+  // What each preprocessing technique removed, summed over all the queries
+  // preprocessed with the same counters.
+  //
+  struct preprocess_stats {
+    size_t queries = 0;
+    size_t clauses_before = 0;
+    size_t clauses_after = 0;
+
+    // universal literals removed from clauses
+    size_t universal_reduction = 0;
+    
+    // variables fixed by unit propagation
+    size_t units = 0;
+
+    // variables fixed because they occur with a single polarity
+    size_t pure_literals = 0;
+
+    // variables replaced by an equivalent literal
+    size_t equivalences = 0;
+
+    // clauses removed because blocked
+    size_t blocked_clauses = 0;
+  };
+
+  std::ostream &operator<<(std::ostream &str, preprocess_stats const& stats);
+
+  //
+  // Simplifies the formula with techniques that preserve its truth as a 
+  // QBF: universal reduction, unit propagation, pure-literal elimination, 
+  // substitution of equivalent literals found in pairs of binary clauses, and
+  // elimination of clauses that are blocked on an existential literal with
+  // respect to variables quantified no later than it. Variables keep their
+  // numbers, and those not occurring anymore are dropped from the prefix. 
+  // A formula found to be true or false is replaced by a trivial one.
+  // Formulas with dependency sets are returned unchanged. When a stop is
+  // requested, simplification ends after the current round, and the result
+  // is equivalent to the input, only less simplified.
+  //
+  qdimacs preprocess(
+    qdimacs const& qd, preprocess_stats &stats, std::stop_token stop = {}
+  );
+
+}
+
+#endif // SYNTH_PREPROCESS_HPP
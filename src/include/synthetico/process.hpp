@@ -0,0 +1,127 @@
+//
+// Synthetico - Pure-past LTL synthesizer based on BLACK
+//
+// (C) 2023 Nicola Gigante
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef SYNTH_PROCESS_HPP
+#define SYNTH_PROCESS_HPP
+
+#include <sys/types.h>
+
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace synth {
+
+  //
+  // Resources granted to a child process. A process running past its
+  // timeout is terminated, while the memory limit is enforced by the kernel
+  // on the child's address space.
+  //
+  struct limits_t {
+    std::optional<std::chrono::milliseconds> timeout;
+    std::optional<size_t> memory; // in bytes
+  };
+
+  //
+  // A child process running either an external program or a function of our
+  // own. An external program gets as standard input whatever the given input
+  // function writes to the file descriptor it receives. In both cases the
+  // standard output is collected through a pipe.
+  // The child is killed and reaped when the object is destroyed, so a process
+  // that is not needed anymore can just be dropped.
+  //
+  // Children running a function lead their own process group, so that killing
+  // them also kills any external program they launched in turn.
+  //
+  class process {
+  public:
+    process(
+      std::vector<std::string> const& argv, 
+      std::function<void(int)> const& input, 
+      limits_t limits = {}
+    );
+    explicit process(std::function<int()> body, limits_t limits = {});
+    process(process const&) = delete;
+    process(process &&other);
+    ~process();
+
+    process &operator=(process const&) = delete;
+    process &operator=(process &&other);
+
+    bool running() const { return _pid != -1; }
+
+    // whether the process was terminated for running past its timeout
+    bool timed_out() const { return _timed_out; }
+    
+    // the output collected so far, complete when the process has terminated
+    std::string const& output() const { return _output; }
+    
+    // the exit status as returned by waitpid()
+    int status() const { return _status; }
+
+    // blocks until the process terminates or runs out of time
+    void wait();
+
+    // terminates the process, as `kill_all` does
+    void kill() noexcept;
+
+    // blocks until one of the given processes terminates or runs out of time,
+    // and returns its index. Null pointers and already terminated processes
+    // are skipped, and procs.size() is returned if there is nothing left to
+    // wait for.
+    static size_t wait_any(std::span<process * const> procs);
+
+    //
+    // Terminates the given processes, first politely with SIGTERM and then,
+    // if they do not exit within a short grace period, with SIGKILL. They 
+    // are all sent SIGTERM at once, so that they share the grace period.
+    // Null pointers and already terminated processes are skipped. Nothing
+    // is thrown, since this is also how destructors stop the children.
+    //
+    static void kill_all(std::span<process * const> procs) noexcept;
+
+  private:
+    void start_clock(limits_t limits);
+    bool expired() const;
+    void drain();
+    void reap();
+    pid_t target() const { return _group ? -_pid : _pid; }
+    bool release(int options) noexcept;
+
+    pid_t _pid = -1;
+    bool _group = false;
+    int _out = -1;
+    int _status = 0;
+    bool _timed_out = false;
+    std::optional<std::chrono::steady_clock::time_point> _deadline;
+    std::string _output;
+  };
+
+}
+
+#endif // SYNTH_PROCESS_HPP
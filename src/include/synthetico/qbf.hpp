@@ -26,8 +26,14 @@
 #define SYNTH_QBF_HPP
 
 #include <black/logic/logic.hpp>
+#include <black/logic/cnf.hpp>
 
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace synth {
   
@@ -36,10 +42,91 @@ namespace synth {
   using qbformula = formula<QBF>;
 
   using var_t = uint32_t;
-  using lit_t = int64_t;
+  using lit_t = int32_t;
 
-  struct clause {
-    std::vector<lit_t> literals;
+  using clause = std::span<lit_t const>;
+
+  //
+  // All the clauses of a formula are stored back to back in a single array of
+  // literals, and each clause is identified by the offset where it begins.
+  // Iterating over the list yields each clause as a span of its literals.
+  // A list can extend a shared base list, whose clauses come first.
+  //
+  class clause_list {
+  public:
+    class iterator {
+    public:
+      using value_type = clause;
+      using difference_type = std::ptrdiff_t;
+
+      iterator() = default;
+      iterator(clause_list const *list, size_t i) : _list{list}, _i{i} { }
+
+      clause operator*() const { return (*_list)[_i]; }
+
+      iterator &operator++() {
+        ++_i;
+        return *this;
+      }
+
+      iterator operator++(int) {
+        iterator it = *this;
+        ++_i;
+        return it;
+      }
+
+      bool operator==(iterator const&) const = default;
+
+    private:
+      clause_list const *_list = nullptr;
+      size_t _i = 0;
+    };
+
+    clause_list() = default;
+    explicit clause_list(std::shared_ptr<clause_list const> base)
+      : _base{std::move(base)} { }
+
+    size_t size() const { return base_size() + _offsets.size() - 1; }
+    bool empty() const { return size() == 0; }
+    size_t n_literals() const { 
+      return (_base ? _base->n_literals() : 0) + _literals.size(); 
+    }
+
+    clause operator[](size_t i) const {
+      if(i < base_size())
+        return (*_base)[i];
+      
+      i -= base_size();
+      return clause{
+        _literals.data() + _offsets[i], _literals.data() + _offsets[i + 1]
+      };
+    }
+
+    iterator begin() const { return iterator{this, 0}; }
+    iterator end() const { return iterator{this, size()}; }
+
+    // makes room for the given number of clauses and literals to be added
+    void reserve(size_t clauses, size_t literals) {
+      _offsets.reserve(_offsets.size() + clauses);
+      _literals.reserve(_literals.size() + literals);
+    }
+
+    // clauses are built by adding their literals one by one and then closing 
+    // them with `close()`
+    void add(lit_t lit) { _literals.push_back(lit); }
+    void close() { _offsets.push_back(_literals.size()); }
+
+    void push_back(clause cl) {
+      _literals.insert(_literals.end(), cl.begin(), cl.end());
+      close();
+    }
+
+  private:
+    size_t base_size() const { return _base ? _base->size() : 0; }
+
+    std::shared_ptr<clause_list const> _base;
+    std::vector<lit_t> _literals;
+    std::vector<size_t> _offsets = {0};
   };
 
   struct qdimacs_block {
@@ -54,16 +141,84 @@ namespace synth {
   struct qdimacs {
     size_t n_vars;
     std::vector<qdimacs_block> blocks;
-    std::vector<clause> clauses;
+    clause_list clauses;
 
-    std::unordered_map<var_t, proposition> props;
+    // indexed by variable, the entry at index 0 is unused. Empty if the
+    // variables do not stand for propositions at all.
+    std::vector<std::optional<proposition>> props;
     std::unordered_map<proposition, var_t> vars;
+
+    //
+    // Existential variables depending only on the given universal ones, as 
+    // in the `d` lines of the DQDIMACS format. They do not appear in any 
+    // block, and make the formula a DQBF, which only some backends accept.
+    //
+    std::vector<std::pair<var_t, std::vector<var_t>>> dependencies;
+  };
+
+  //
+  // A formula in prenex form whose matrix is the conjunction of the given
+  // pieces, already in CNF. Pieces can be shared among many formulas.
+  //
+  struct prenex_cnf {
+    std::vector<std::pair<quantifier_t, std::vector<proposition>>> blocks;
+    std::vector<std::shared_ptr<black::cnf const>> matrix;
+  };
+
+  //
+  // How Boolean formulas are turned into CNF. The `tseitin` encoding is 
+  // BLACK's own, which defines each subformula in both directions, while the
+  // `polarity` encoding (Plaisted-Greenbaum) only emits the direction needed
+  // by the polarity of each occurrence, and gives a single variable to
+  // chains of conjunctions or disjunctions.
+  //
+  enum class clausifier_t {
+    tseitin,
+    polarity
   };
 
+  std::string to_string(clausifier_t clausifier);
+  std::optional<clausifier_t> to_clausifier(std::string const& name);
+
+  black::cnf to_cnf(bformula f, clausifier_t clausifier);
+
+  //
+  // The CNF of one step of an unrolling, over the `width` variables of the
+  // step and the first `n_state` variables of the next one, which are 
+  // numbered from width + 1. The copy at step k is obtained by shifting each
+  // literal by k * width, so the unrolling over n steps takes up the first 
+  // n * width + n_state variables.
+  //
+  struct clause_template {
+    size_t width;
+    size_t n_state;
+    clause_list clauses;
+  };
+
+  //
+  // `flatten` gives distinct names to the variables bound by distinct 
+  // quantifiers, and `prenex` moves the quantifiers of a flattened formula 
+  // to the front, with as few alternations as it can. Flattening copies
+  // each occurrence of a quantified subformula, while quantifier-free ones
+  // are kept shared. Prenexing takes time linear in the number of distinct
+  // subformulas.
+  //
   qbformula flatten(qbformula f);
   qbformula prenex(qbformula f);
-  qdimacs clausify(qbformula f);
-  std::string to_string(qdimacs qd);
+  qdimacs clausify(
+    qbformula f, clausifier_t clausifier = clausifier_t::tseitin
+  );
+  qdimacs clausify(prenex_cnf const& f);
+
+  // appends to `out` the copies of the template at steps 0 to n - 1
+  void unroll(clause_template const& t, size_t n, clause_list &out);
+  
+  //
+  // Writes the formula in QDIMACS format directly to the given file 
+  // descriptor, and returns the number of bytes written.
+  //
+  size_t write(qdimacs const& qd, int fd);
+  std::string to_string(qdimacs const& qd);
 
 }
 
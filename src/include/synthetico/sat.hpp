@@ -0,0 +1,92 @@
+//
+// Synthetico - Pure-past LTL synthesizer based on BLACK
+//
+// (C) 2023 Nicola Gigante
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#ifndef SYNTH_SAT_HPP
+#define SYNTH_SAT_HPP
+
+#include "synthetico/common.hpp"
+#include "synthetico/qbf.hpp"
+
+#include <black/sat/solver.hpp>
+#include <black/support/tribool.hpp>
+
+#include <memory>
+#include <span>
+#include <string>
+
+namespace synth {
+
+  // the name of the proposition standing for a variable of a SAT solver
+  struct sat_var_t {
+    var_t var;
+
+    bool operator==(sat_var_t const&) const = default;
+  };
+
+  inline std::string to_string(sat_var_t v) {
+    return "{sat " + std::to_string(v.var) + "}";
+  }
+
+  //
+  // One of BLACK's incremental SAT backends, running in our own process and
+  // fed with clauses over numbered variables, each of which stands for a 
+  // proposition of its own. The first available backend among the ones 
+  // BLACK can be built with is used.
+  //
+  class sat_solver {
+  public:
+    explicit sat_solver(logic::alphabet &sigma);
+
+    static bool is_available();
+
+    void add(clause cl);
+    void add(clause_list const& clauses);
+
+    // whether the clauses added so far are satisfiable together with the
+    // given literals
+    black::tribool solve(std::span<lit_t const> assumptions = {});
+
+    // the value of the variable in the last model found
+    bool value(var_t var) const;
+
+  private:
+    bformula literal(lit_t lit) const;
+
+    logic::alphabet *_sigma;
+    std::unique_ptr<black::sat::solver> _solver;
+  };
+
+}
+
+namespace std {
+  template<>
+  struct hash<::synth::sat_var_t> {
+    size_t operator()(::synth::sat_var_t v) {
+      return std::hash<::synth::var_t>{}(v.var);
+    }
+  };
+}
+
+#endif // SYNTH_SAT_HPP
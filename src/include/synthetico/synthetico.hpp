@@ -27,16 +27,26 @@
 
 #include "synthetico/common.hpp"
 #include "synthetico/spec.hpp"
+#include "synthetico/qbf.hpp"
+#include "synthetico/aig.hpp"
+#include "synthetico/preprocess.hpp"
 #include "synthetico/automata.hpp"
 #include "automatabdd.hpp"
 #include "transducer.hpp"
 #include "quantification.hpp"
 #include "varmgr.hpp"
-#include "synthetico/qbf.hpp"
+#include "synthetico/process.hpp"
+#include "synthetico/cache.hpp"
 #include "synthetico/backend.hpp"
+#include "synthetico/sat.hpp"
 #include "synthetico/random.hpp"
 #include "synthetico/game/qbf.hpp"
+#include "synthetico/game/threshold.hpp"
+#include "synthetico/game/dqbf.hpp"
+#include "synthetico/game/expansion.hpp"
+#include "synthetico/game/cegar.hpp"
 #include "synthetico/game/bdd.hpp"
+#include "synthetico/game/portfolio.hpp"
 
 
 #endif // SYNTH_SYNTH_HPP
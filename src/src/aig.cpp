@@ -0,0 +1,295 @@
+//
+// Synthetico - Pure-past LTL synthesizer based on BLACK
+//
+// (C) 2023 Nicola Gigante
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#include "synthetico/synthetico.hpp"
+
+#include <array>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace synth {
+
+  aig::edge aig::input() {
+    if(_nodes.size() > std::numeric_limits<edge>::max() / 2)
+      throw std::runtime_error("too many nodes in the and-inverter graph");
+    
+    _nodes.push_back(node_t{});
+    return edge((_nodes.size() - 1) * 2);
+  }
+
+  aig::edge aig::land(edge a, edge b) {
+    if(a > b)
+      std::swap(a, b);
+
+    // one level
+    if(a == bottom || a == negate(b))
+      return bottom;
+    if(a == top || a == b)
+      return b;
+
+    // two levels, looking at the gates below a and b
+    for(auto [x, y] : {std::pair{a, b}, std::pair{b, a}}) {
+      if(!is_gate(node(x)))
+        continue;
+      
+      edge l = left(node(x));
+      edge r = right(node(x));
+
+      if(!negated(x)) {
+        // contradiction
+        if(y == negate(l) || y == negate(r))
+          return bottom;
+        // idempotence
+        if(y == l || y == r)
+          return x;
+        // contradiction between two gates
+        if(!negated(y) && is_gate(node(y))) {
+          edge l2 = left(node(y));
+          edge r2 = right(node(y));
+          if(l2 == negate(l) || l2 == negate(r) || 
+             r2 == negate(l) || r2 == negate(r))
+            return bottom;
+        }
+      } else {
+        // subsumption
+        if(y == negate(l) || y == negate(r))
+          return y;
+        // substitution
+        if(y == l)
+          return land(y, negate(r));
+        if(y == r)
+          return land(y, negate(l));
+      }
+    }
+
+    return make_and(a, b);
+  }
+
+  aig::edge aig::make_and(edge a, edge b) {
+    uint64_t key = (uint64_t(a) << 32) | b;
+    if(auto it = _gates.find(key); it != _gates.end())
+      return it->second;
+
+    edge e = input();
+    _nodes.back() = node_t{a, b};
+    _gates.insert({key, e});
+
+    return e;
+  }
+
+  aig::edge 
+  aig::copy(aig const& g, edge e, std::unordered_map<size_t, edge> &map) {
+    if(g.node(e) == 0)
+      return e;
+
+    auto it = map.find(node(e));
+    if(it != map.end())
+      return negated(e) ? negate(it->second) : it->second;
+    
+    black_assert(g.is_gate(node(e)));
+    edge l = copy(g, g.left(node(e)), map);
+    edge r = copy(g, g.right(node(e)), map);
+    edge result = land(l, r);
+    map.insert({node(e), result});
+
+    return negated(e) ? negate(result) : result;
+  }
+
+  aig::edge to_aig(
+    aig &g, bformula f, std::function<aig::edge(proposition)> const& inputs
+  ) {
+    std::unordered_map<bformula, aig::edge> memo;
+
+    std::function<aig::edge(bformula)> build = [&](bformula h) {
+      if(auto it = memo.find(h); it != memo.end())
+        return it->second;
+
+      aig::edge result = h.match(
+        [](logic::boolean b) { 
+          return b.value() ? aig::top : aig::bottom; 
+        },
+        [&](proposition p) { 
+          return inputs(p); 
+        },
+        [&](logic::negation<Bool>, auto arg) {
+          return aig::negate(build(arg));
+        },
+        [&](logic::conjunction<Bool>, auto left, auto right) {
+          return g.land(build(left), build(right));
+        },
+        [&](logic::disjunction<Bool>, auto left, auto right) {
+          return g.lor(build(left), build(right));
+        },
+        [&](logic::implication<Bool>, auto left, auto right) {
+          return g.implies(build(left), build(right));
+        },
+        [&](logic::iff<Bool>, auto left, auto right) {
+          return g.iff(build(left), build(right));
+        }
+      );
+      memo.insert({h, result});
+
+      return result;
+    };
+
+    return build(f);
+  }
+
+  namespace {
+    struct aig_encoder {
+      enum : uint8_t {
+        positive = 1,
+        negative = 2
+      };
+
+      static uint8_t flip(uint8_t pol) {
+        return uint8_t(((pol & positive) << 1) | ((pol & negative) >> 1));
+      }
+
+      std::vector<aig::edge> operands(size_t n) const;
+      void assert_true(aig::edge e);
+      lit_t encode(aig::edge e, uint8_t pol);
+
+      void add(std::span<lit_t const> cl) { out.push_back(cl); }
+
+      aig const& g;
+      bool polarity;
+      std::vector<var_t> &vars;
+      var_t &next;
+      clause_list &out;
+      std::vector<uint8_t> encoded = std::vector<uint8_t>(g.size(), 0);
+    };
+
+    // the leaves of the chain of non-negated gates rooted at gate n
+    std::vector<aig::edge> aig_encoder::operands(size_t n) const {
+      std::vector<aig::edge> result;
+      std::vector<aig::edge> stack = {g.right(n), g.left(n)};
+      while(!stack.empty()) {
+        aig::edge e = stack.back();
+        stack.pop_back();
+
+        if(!aig::negated(e) && g.is_gate(aig::node(e))) {
+          stack.push_back(g.right(aig::node(e)));
+          stack.push_back(g.left(aig::node(e)));
+        } else
+          result.push_back(e);
+      }
+
+      return result;
+    }
+
+    void aig_encoder::assert_true(aig::edge e) {
+      if(e == aig::top)
+        return;
+      if(e == aig::bottom) {
+        add({});
+        return;
+      }
+      
+      size_t n = aig::node(e);
+      if(!g.is_gate(n)) {
+        lit_t lit = encode(e, positive);
+        add(std::span{&lit, 1});
+        return;
+      }
+
+      if(!aig::negated(e)) {
+        for(aig::edge arg : operands(n))
+          assert_true(arg);
+        return;
+      }
+
+      std::vector<lit_t> cl;
+      for(aig::edge arg : operands(n))
+        cl.push_back(encode(aig::negate(arg), positive));
+      add(cl);
+    }
+
+    lit_t aig_encoder::encode(aig::edge e, uint8_t pol) {
+      if(aig::negated(e))
+        return -encode(aig::negate(e), flip(pol));
+
+      size_t n = aig::node(e);
+      black_assert(n != 0);
+      
+      if(!polarity)
+        pol = positive | negative;
+
+      if(!g.is_gate(n)) {
+        black_assert(vars[n] != 0);
+        return lit_t(vars[n]);
+      }
+
+      if(vars[n] == 0) {
+        if(next > var_t(std::numeric_limits<lit_t>::max()))
+          throw std::runtime_error(
+            "too many variables for the QDIMACS encoding"
+          );
+        vars[n] = next++;
+      }
+      lit_t t = lit_t(vars[n]);
+
+      uint8_t todo = uint8_t(pol & ~encoded[n]);
+      encoded[n] |= pol;
+      if(!todo)
+        return t;
+
+      std::vector<lit_t> args;
+      for(aig::edge arg : operands(n))
+        args.push_back(encode(arg, todo));
+
+      if(todo & positive) {
+        for(lit_t arg : args) {
+          std::array<lit_t, 2> cl = {-t, arg};
+          add(cl);
+        }
+      }
+      if(todo & negative) {
+        std::vector<lit_t> cl = {t};
+        for(lit_t arg : args)
+          cl.push_back(-arg);
+        add(cl);
+      }
+
+      return t;
+    }
+  }
+
+  void clausify(
+    aig const& g, std::span<aig::edge const> roots, clausifier_t clausifier,
+    std::vector<var_t> &vars, var_t &next, clause_list &out
+  ) {
+    black_assert(vars.size() >= g.size());
+
+    aig_encoder enc{
+      g, clausifier == clausifier_t::polarity, vars, next, out
+    };
+    for(aig::edge e : roots)
+      enc.assert_true(e);
+  }
+
+}
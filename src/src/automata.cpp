@@ -26,6 +26,7 @@
 
 #include <black/logic/prettyprint.hpp>
 
+#include <unordered_map>
 #include <unordered_set>
 
 namespace synth {
@@ -262,6 +263,83 @@ namespace synth {
     return encoder{}.encode(sp);
   }
 
+  namespace {
+    void definitions(
+      bformula f, std::unordered_map<proposition, bformula> &defs
+    ) {
+      if(auto c = f.to<logic::conjunction<Bool>>(); c) {
+        definitions(c->left(), defs);
+        definitions(c->right(), defs);
+      } else if(auto d = f.to<logic::iff<Bool>>(); d) {
+        auto p = d->left().to<proposition>();
+        black_assert(p.has_value());
+        defs.insert({*p, d->right()});
+      } else
+        black_assert(f.is<logic::boolean>());
+    }
+
+    void literals(bformula f, std::unordered_map<proposition, bool> &values) {
+      if(auto c = f.to<logic::conjunction<Bool>>(); c) {
+        literals(c->left(), values);
+        literals(c->right(), values);
+      } else if(auto n = f.to<logic::negation<Bool>>(); n) {
+        auto p = n->argument().to<proposition>();
+        black_assert(p.has_value());
+        values.insert({*p, false});
+      } else if(auto p = f.to<proposition>(); p) {
+        values.insert({*p, true});
+      } else
+        black_assert(f.is<logic::boolean>());
+    }
+  }
+
+  std::vector<bformula> next_state(automata const& aut) {
+    std::unordered_map<proposition, bformula> defs;
+    definitions(aut.trans, defs);
+
+    std::vector<bformula> result;
+    for(proposition v : aut.variables) {
+      auto it = defs.find(primed(v));
+      black_assert(it != defs.end());
+      result.push_back(it->second);
+    }
+
+    return result;
+  }
+
+  std::vector<bool> initial_state(automata const& aut) {
+    std::unordered_map<proposition, bool> values;
+    literals(aut.init, values);
+
+    std::vector<bool> result;
+    for(proposition v : aut.variables) {
+      auto it = values.find(v);
+      black_assert(it != values.end());
+      result.push_back(it->second);
+    }
+
+    return result;
+  }
+
+  automata_aig to_aig(automata const& aut) {
+    automata_aig result{};
+
+    std::unordered_map<proposition, aig::edge> inputs;
+    for(auto const& props : {aut.variables, aut.inputs, aut.outputs})
+      for(proposition p : props)
+        inputs.insert({p, result.graph.input()});
+    for(proposition p : aut.variables)
+      inputs.insert({primed(p), result.graph.input()});
+
+    auto input = [&](proposition p) { return inputs.at(p); };
+
+    result.init = to_aig(result.graph, aut.init, input);
+    result.trans = to_aig(result.graph, aut.trans, input);
+    result.objective = to_aig(result.graph, aut.objective, input);
+
+    return result;
+  }
+
   std::ostream &operator<<(std::ostream &str, automata aut) {
     str << "inputs:\n";
     for(auto in : aut.inputs) {
@@ -24,93 +24,360 @@
 
 #include "synthetico/synthetico.hpp"
 
-#include <unistd.h>
-#include <fcntl.h>
+#ifdef SYNTH_HAVE_DEPQBF
+extern "C" {
+  #include <qdpll.h>
+}
+#endif
+
 #include <sys/wait.h>
-#include <cstdio>
-#include <cstring>
 
-#include <iostream>
-#include <fstream>
-#include <memory>
-#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 
 namespace synth {
 
-  static void dump(qdimacs const& qd, std::string filename) {
-    std::ofstream fstr(filename);
+  #ifdef SYNTH_HAVE_DEPQBF
+    static constexpr bool has_depqbf = true;
+  #else
+    static constexpr bool has_depqbf = false;
+  #endif
 
-    if(fstr.fail())
-      throw std::runtime_error(
-        "unable to open file '" + filename + "': " + strerror(errno)
-      );
-    
-    fstr << to_string(qd) << "\n";
+  namespace {
+    struct command {
+      std::vector<std::string> argv;
+      std::string sat;
+      std::string unsat;
+    };
   }
 
-  black::tribool is_sat(qdimacs const& qd) {
+  static command external_command(backend_t backend) {
+    switch(backend) {
+      case backend_t::pedant:
+        return {{"pedant", "/dev/stdin"}, "SATISFIABLE", "UNSATISFIABLE"};
+      case backend_t::dqbdd:
+        return {{"dqbdd", "/dev/stdin"}, "SAT", "UNSAT"};
+      case backend_t::depqbf:
+        break;
+    }
+    black_unreachable();
+  }
 
-    using namespace std::literals;
+  std::string to_string(backend_t backend) {
+    switch(backend) {
+      case backend_t::pedant:
+        return "pedant";
+      case backend_t::dqbdd:
+        return "dqbdd";
+      case backend_t::depqbf:
+        return "depqbf";
+    }
+    black_unreachable();
+  }
 
-    std::mt19937 gen(std::random_device{}());
-    std::uniform_int_distribution<size_t> dist(1, 99999);
+  std::optional<backend_t> to_backend(std::string const& name) {
+    for(auto b : {backend_t::pedant, backend_t::dqbdd, backend_t::depqbf})
+      if(to_string(b) == name)
+        return b;
+    return std::nullopt;
+  }
 
-    std::string input_filename = 
-      "synth-" + std::to_string(dist(gen)) + ".dqdimacs";
+  bool is_external(backend_t backend) {
+    return backend != backend_t::depqbf;
+  }
 
-    dump(qd, input_filename);
+  bool is_available(backend_t backend) {
+    return is_external(backend) || has_depqbf;
+  }
 
-    std::string output_filename = 
-      "synth-" + std::to_string(dist(gen)) + ".out";
+  //
+  // DepQBF is fed directly from the qdimacs structure through its API.
+  // Empty quantifier blocks are skipped and adjacent blocks of the same type
+  // are merged, since DepQBF's scopes must strictly alternate.
+  //
+  static black::tribool solve_depqbf([[maybe_unused]] qdimacs const& qd) {
+  #ifdef SYNTH_HAVE_DEPQBF
+    QDPLL *solver = qdpll_create();
+    qdpll_configure(solver, const_cast<char *>("--dep-man=simple"));
+    qdpll_adjust_vars(solver, VarID(qd.n_vars));
 
-    int fd = open(output_filename.c_str(), O_WRONLY | O_CREAT, 0600);
-    int null = open("/dev/null", O_WRONLY);
+    bool open = false;
+    auto last = qdimacs_block::existential;
+    for(auto const& block : qd.blocks) {
+      if(block.variables.empty())
+        continue;
+      
+      if(!open || block.type != last) {
+        if(open)
+          qdpll_add(solver, 0);
+        qdpll_new_scope(solver, 
+          block.type == qdimacs_block::existential ? 
+            QDPLL_QTYPE_EXISTS : QDPLL_QTYPE_FORALL
+        );
+        open = true;
+        last = block.type;
+      }
+      
+      for(var_t var : block.variables)
+        qdpll_add(solver, LitID(var));
+    }
+    if(open)
+      qdpll_add(solver, 0);
 
-    if(fd == -1) {
+    for(clause cl : qd.clauses) {
+      for(lit_t lit : cl)
+        qdpll_add(solver, LitID(lit));
+      qdpll_add(solver, 0);
+    }
+
+    QDPLLResult res = qdpll_sat(solver);
+    qdpll_delete(solver);
+
+    if(res == QDPLL_RESULT_SAT)
+      return true;
+    if(res == QDPLL_RESULT_UNSAT)
+      return false;
+    return black::tribool::undef;
+  #else
+    black_unreachable();
+  #endif
+  }
+
+  // the usual SAT competition exit codes, understood by query::result()
+  static int exit_code(black::tribool result) {
+    if(result == true)
+      return 10;
+    if(result == false)
+      return 20;
+    return 0;
+  }
+
+  //
+  // Backends linked into our own process solve the query in a forked child,
+  // so that they run in the background and can be stopped like the external
+  // ones. The child gets the query straight from memory, and reports the 
+  // answer through its exit code.
+  //
+  query::query(
+    qdimacs const& qd, backend_t backend, 
+    limits_t limits, cache const *results
+  ) : _backend{backend}, _cache{results}
+  {
+    if(!is_available(backend))
       throw std::runtime_error(
-        "unable to open file '" + output_filename + "': " + strerror(errno)
+        "backend '" + to_string(backend) + "' is not available in this build"
       );
-    }
-    if(null == -1) {
+
+    if(!qd.dependencies.empty() && !is_external(backend))
       throw std::runtime_error(
-        "unable to open /dev/null: "s + strerror(errno)
+        "backend '" + to_string(backend) + "' does not support DQBF queries"
       );
+
+    if(_cache) {
+      _key = cache::key(qd);
+      if(auto hit = _cache->lookup(_key); hit) {
+        _result = *hit;
+        return;
+      }
     }
 
-    pid_t pid = fork();
+    if(is_external(backend))
+      _process.emplace(
+        external_command(backend).argv, 
+        [&](int fd) { _size = write(qd, fd); }, 
+        limits
+      );
+    else
+      _process.emplace([&]() { return exit_code(solve_depqbf(qd)); }, limits);
+  }
+
+  incremental_solver::incremental_solver(backend_t backend) {
+    if(!is_supported(backend))
+      throw std::runtime_error(
+        "backend '" + to_string(backend) + "' does not support incremental "
+        "solving in this build"
+      );
+  #ifdef SYNTH_HAVE_DEPQBF
+    _solver = qdpll_create();
+    qdpll_configure(_solver, const_cast<char *>("--dep-man=simple"));
+    qdpll_configure(_solver, const_cast<char *>("--incremental-use"));
+  #endif
+  }
 
-    if(!pid) { // child process
-      dup2(fd, 1);
-      dup2(null, 2);
-      execlp("pedant", "pedant", input_filename.c_str(), nullptr);
-      
-      throw std::runtime_error("unable to launch backend: "s + strerror(errno));
+  incremental_solver::~incremental_solver() {
+  #ifdef SYNTH_HAVE_DEPQBF
+    qdpll_delete(_solver);
+  #endif
+  }
+
+  bool incremental_solver::is_supported(backend_t backend) {
+    return backend == backend_t::depqbf && has_depqbf;
+  }
+
+  void incremental_solver::declare(var_t var) {
+    if(var <= _n_vars)
+      return;
+
+    _n_vars = var;
+  #ifdef SYNTH_HAVE_DEPQBF
+    qdpll_adjust_vars(_solver, VarID(_n_vars));
+  #endif
+  }
+
+  //
+  // DepQBF's scopes are numbered from 1, outermost first, and must strictly
+  // alternate.
+  //
+  void incremental_solver::add(qdimacs_block const& block) {
+    if(block.variables.empty())
+      return;
+
+    for(var_t var : block.variables)
+      declare(var);
+
+    [[maybe_unused]] bool merge = _nesting > 0 && block.type == _innermost;
+    _innermost = block.type;
+  #ifdef SYNTH_HAVE_DEPQBF
+    if(merge) {
+      for(var_t var : block.variables)
+        qdpll_add_var_to_scope(_solver, VarID(var), _nesting);
+      return;
     }
 
-    close(fd);
-    wait(NULL);
+    _nesting = qdpll_new_scope(_solver, 
+      block.type == qdimacs_block::existential ? 
+        QDPLL_QTYPE_EXISTS : QDPLL_QTYPE_FORALL
+    );
+    for(var_t var : block.variables)
+      qdpll_add(_solver, LitID(var));
+    qdpll_add(_solver, 0);
+  #endif
+  }
+
+  void incremental_solver::add_outermost(var_t var) {
+    black_assert(_nesting > 0);
+    declare(var);
+  #ifdef SYNTH_HAVE_DEPQBF
+    qdpll_add_var_to_scope(_solver, VarID(var), 1);
+  #endif
+  }
+
+  void incremental_solver::add([[maybe_unused]] clause cl) {
+  #ifdef SYNTH_HAVE_DEPQBF
+    for(lit_t lit : cl)
+      qdpll_add(_solver, LitID(lit));
+    qdpll_add(_solver, 0);
+  #endif
+  }
+
+  //
+  // DepQBF must be reset after each call before being modified or called 
+  // again, and forgets the assumptions while doing so.
+  //
+  black::tribool incremental_solver::solve(
+    [[maybe_unused]] std::span<lit_t const> assumptions
+  ) {
+  #ifdef SYNTH_HAVE_DEPQBF
+    for(lit_t lit : assumptions)
+      qdpll_assume(_solver, LitID(lit));
+
+    QDPLLResult res = qdpll_sat(_solver);
+    qdpll_reset(_solver);
+
+    if(res == QDPLL_RESULT_SAT)
+      return true;
+    if(res == QDPLL_RESULT_UNSAT)
+      return false;
+    return black::tribool::undef;
+  #else
+    black_unreachable();
+  #endif
+  }
+
+  void query::record(black::tribool result) {
+    _result = result;
+    if(_cache && result == true)
+      _cache->store(_key, true);
+    else if(_cache && result == false)
+      _cache->store(_key, false);
+  }
+
+  bool query::done() const {
+    return _result.has_value() || !_process->running();
+  }
+
+  black::tribool query::result() {
+    if(_result)
+      return *_result;
 
-    std::ifstream fstr(output_filename);
-    if(!fstr.good())
+    _process->wait();
+    
+    int status = _process->status();
+    if(WIFEXITED(status) && WEXITSTATUS(status) == 127)
       throw std::runtime_error(
-        "unable to open backend output file '" + 
-        output_filename + "': " + strerror(errno)
+        "unable to launch backend '" + to_string(_backend) + "'"
       );
 
-    while(fstr.good()) {
+    std::optional<bool> verdict;
+
+    if(is_external(_backend)) {
+      command cmd = external_command(_backend);
+      std::istringstream lines(_process->output());
       std::string line;
-      std::getline(fstr, line);
+      while(!verdict && std::getline(lines, line)) {
+        if(line == cmd.sat)
+          verdict = true;
+        else if(line == cmd.unsat)
+          verdict = false;
+      }
+    }
 
-      if(line == "SATISFIABLE")
-        return true;
-      if(line == "UNSATISFIABLE")
-        return false;
+    // fall back to the usual SAT competition exit codes
+    if(!verdict && WIFEXITED(status)) {
+      if(WEXITSTATUS(status) == 10)
+        verdict = true;
+      else if(WEXITSTATUS(status) == 20)
+        verdict = false;
     }
 
-    return black::tribool::undef;
+    record(verdict ? black::tribool{*verdict} : black::tribool::undef);
+
+    return *_result;
+  }
+
+  void query::cancel() {
+    if(_process)
+      _process->kill();
+  }
+
+  size_t query::wait_any(std::span<query * const> queries) {
+    std::vector<process *> procs;
+    for(size_t i = 0; i < queries.size(); i++) {
+      if(queries[i] && queries[i]->done())
+        return i;
+      procs.push_back(queries[i] ? &*queries[i]->_process : nullptr);
+    }
+
+    return process::wait_any(procs);
+  }
+
+  void query::cancel_all(std::span<query * const> queries) {
+    std::vector<process *> procs;
+    for(query *q : queries)
+      if(q && q->_process)
+        procs.push_back(&*q->_process);
+
+    process::kill_all(procs);
+  }
+
+  black::tribool is_sat(
+    qdimacs const& qd, backend_t backend, limits_t limits, cache const *results
+  ) {
+    return query{qd, backend, limits, results}.result();
   }
 
-  black::tribool is_sat(qbformula f) {
+  black::tribool is_sat(qbformula f, backend_t backend) {
     //std::cerr << "formula: " << to_string(f) << "\n";
     
     auto fl = flatten(f);
@@ -122,7 +389,7 @@ namespace synth {
     auto cl = clausify(pr);
     //std::cerr << "QDIMACS: \n"  << to_string(cl) << "\n";
 
-    return is_sat(cl);
+    return is_sat(cl, backend);
   }
 
 }
@@ -0,0 +1,199 @@
+//
+// Synthetico - Pure-past LTL synthesizer based on BLACK
+//
+// (C) 2023 Nicola Gigante
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#include "synthetico/synthetico.hpp"
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <cerrno>
+#include <cstring>
+
+#include <algorithm>
+#include <cstdio>
+#include <span>
+#include <stdexcept>
+
+namespace synth {
+
+  namespace {
+    //
+    // Two independent 64-bit hashes of the same stream of words, giving a 
+    // 128-bit key for which collisions are not a practical concern.
+    //
+    struct hasher {
+      void add(uint64_t word) {
+        for(int i = 0; i < 8; i++) {
+          fnv ^= (word >> (8 * i)) & 0xff;
+          fnv *= 0x100000001b3;
+        }
+
+        mix += word + 0x9e3779b97f4a7c15;
+        mix = (mix ^ (mix >> 30)) * 0xbf58476d1ce4e5b9;
+        mix = (mix ^ (mix >> 27)) * 0x94d049bb133111eb;
+        mix ^= mix >> 31;
+      }
+
+      std::string hex() const {
+        char buf[33];
+        snprintf(buf, sizeof(buf), "%016llx%016llx", 
+          (unsigned long long)fnv, (unsigned long long)mix);
+        return buf;
+      }
+
+      uint64_t fnv = 0xcbf29ce484222325;
+      uint64_t mix = 0;
+    };
+  }
+
+  cache::cache(std::filesystem::path dir) : _dir{std::move(dir)} {
+    std::error_code ec;
+    std::filesystem::create_directories(_dir, ec);
+    if(ec)
+      throw std::runtime_error(
+        "unable to create cache directory '" + _dir.string() + "': " + 
+        ec.message()
+      );
+  }
+
+  std::string cache::key(qdimacs const& qd) {
+    hasher h;
+
+    // prefix, with empty blocks dropped and adjacent blocks of the same type
+    // merged, since they do not change the meaning of the formula
+    std::vector<std::pair<uint64_t, std::vector<var_t>>> prefix;
+    for(auto const& block : qd.blocks) {
+      if(block.variables.empty())
+        continue;
+      
+      uint64_t type = block.type == qdimacs_block::existential ? 1 : 2;
+      if(prefix.empty() || prefix.back().first != type)
+        prefix.push_back({type, {}});
+      
+      auto &vars = prefix.back().second;
+      vars.insert(vars.end(), block.variables.begin(), block.variables.end());
+    }
+
+    for(auto &[type, vars] : prefix) {
+      std::sort(vars.begin(), vars.end());
+      h.add(type);
+      for(var_t v : vars)
+        h.add(v);
+      h.add(0);
+    }
+
+    // dependency sets, if any, so that the keys of plain QBFs are unchanged
+    if(!qd.dependencies.empty()) {
+      auto deps = qd.dependencies;
+      std::sort(deps.begin(), deps.end());
+      h.add(4);
+      for(auto &[var, set] : deps) {
+        std::sort(set.begin(), set.end());
+        h.add(var);
+        for(var_t v : set)
+          h.add(v);
+        h.add(0);
+      }
+    }
+
+    // matrix
+    std::vector<lit_t> literals;
+    literals.reserve(qd.clauses.n_literals());
+    for(clause cl : qd.clauses)
+      literals.insert(literals.end(), cl.begin(), cl.end());
+
+    std::vector<std::span<lit_t>> clauses;
+    clauses.reserve(qd.clauses.size());
+    for(size_t i = 0, begin = 0; i < qd.clauses.size(); ++i) {
+      size_t size = qd.clauses[i].size();
+      std::span<lit_t> cl{literals.data() + begin, size};
+      std::sort(cl.begin(), cl.end());
+      clauses.push_back(cl);
+      begin += size;
+    }
+    std::sort(clauses.begin(), clauses.end(), [](auto a, auto b) {
+      return std::lexicographical_compare(
+        a.begin(), a.end(), b.begin(), b.end()
+      );
+    });
+
+    h.add(3);
+    for(auto cl : clauses) {
+      for(lit_t lit : cl)
+        h.add(uint64_t(lit));
+      h.add(0);
+    }
+
+    return h.hex();
+  }
+
+  std::filesystem::path cache::entry(std::string const& key) const {
+    return _dir / key.substr(0, 2) / key.substr(2);
+  }
+
+  //
+  // I/O errors are not fatal: at worst, a lookup misses and a result is not
+  // stored, and the query is solved as if there were no cache.
+  //
+  std::optional<bool> cache::lookup(std::string const& key) const {
+    int fd = open(entry(key).c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd == -1)
+      return std::nullopt;
+
+    char buf[16] = {};
+    ssize_t n = -1;
+    if(flock(fd, LOCK_SH) == 0)
+      n = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+
+    if(n <= 0)
+      return std::nullopt;
+    if(strcmp(buf, "SAT\n") == 0)
+      return true;
+    if(strcmp(buf, "UNSAT\n") == 0)
+      return false;
+    return std::nullopt;
+  }
+
+  void cache::store(std::string const& key, bool sat) const {
+    std::filesystem::path path = entry(key);
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    if(ec)
+      return;
+
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    if(fd == -1)
+      return;
+
+    std::string_view data = sat ? "SAT\n" : "UNSAT\n";
+    if(flock(fd, LOCK_EX) == 0 && ftruncate(fd, 0) == 0) {
+      [[maybe_unused]] 
+      ssize_t n = ::write(fd, data.data(), data.size());
+    }
+    close(fd);
+  }
+
+}
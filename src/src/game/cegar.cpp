@@ -0,0 +1,471 @@
+//
+// Synthetico - Pure-past LTL synthesizer based on BLACK
+//
+// (C) 2023 Nicola Gigante
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#include "synthetico/synthetico.hpp"
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace synth {
+
+  //
+  // The counter-moves found at a position of a game, and the positions 
+  // reached from it by the candidate moves that were refuted.
+  //
+  struct cegar::refutations {
+    std::vector<std::vector<bool>> moves;
+    std::map<std::vector<bool>, std::unique_ptr<refutations>> replies;
+
+    refutations *reply(std::vector<bool> const& move) {
+      std::unique_ptr<refutations> &r = replies[move];
+      if(!r)
+        r = std::make_unique<refutations>();
+      return r.get();
+    }
+
+    void learn(std::vector<bool> const& move) {
+      if(std::find(moves.begin(), moves.end(), move) == moves.end())
+        moves.push_back(move);
+    }
+  };
+
+  namespace {
+    // the moves of each level of a game, as input nodes of a graph
+    using levels_t = std::vector<std::vector<aig::edge>>;
+
+    aig::edge constant(bool value) {
+      return value ? aig::top : aig::bottom;
+    }
+
+    //
+    // A SAT solver fed with edges of a graph. The inputs of the graph get a 
+    // variable when they are first reached.
+    //
+    struct instance {
+      instance(aig &g, logic::alphabet &sigma) : graph{g}, solver{sigma} { }
+
+      void assert_true(aig::edge e);
+      bool solve(
+        std::vector<aig::edge> const& inputs, std::vector<bool> const& values
+      );
+      std::vector<bool> model(std::vector<aig::edge> const& inputs) const;
+      var_t var(aig::edge input) const;
+
+      aig &graph;
+      sat_solver solver;
+      std::vector<var_t> vars;
+      var_t next = 1;
+    };
+
+    void instance::assert_true(aig::edge e) {
+      vars.resize(graph.size(), 0);
+
+      std::vector<bool> seen(graph.size(), false);
+      std::vector<size_t> stack = {aig::node(e)};
+      while(!stack.empty()) {
+        size_t n = stack.back();
+        stack.pop_back();
+        if(n == 0 || seen[n])
+          continue;
+        seen[n] = true;
+
+        if(graph.is_gate(n)) {
+          stack.push_back(aig::node(graph.left(n)));
+          stack.push_back(aig::node(graph.right(n)));
+        } else if(vars[n] == 0)
+          vars[n] = next++;
+      }
+
+      clause_list clauses;
+      std::array<aig::edge, 1> roots = {e};
+      clausify(graph, roots, clausifier_t::polarity, vars, next, clauses);
+      solver.add(clauses);
+    }
+
+    var_t instance::var(aig::edge input) const {
+      size_t n = aig::node(input);
+      return n < vars.size() ? vars[n] : 0;
+    }
+
+    // whether the edges asserted so far are satisfiable with the given values
+    // of the given inputs
+    bool instance::solve(
+      std::vector<aig::edge> const& inputs, std::vector<bool> const& values
+    ) {
+      std::vector<lit_t> assumptions;
+      for(size_t j = 0; j < inputs.size(); j++)
+        if(var_t v = var(inputs[j]); v != 0)
+          assumptions.push_back(values[j] ? lit_t(v) : -lit_t(v));
+
+      black::tribool result = solver.solve(assumptions);
+      if(result == black::tribool::undef)
+        throw std::runtime_error("the SAT backend could not decide a query");
+
+      return result == true;
+    }
+
+    // the values of the given inputs in the last model found, where inputs
+    // never reached are false
+    std::vector<bool> 
+    instance::model(std::vector<aig::edge> const& inputs) const {
+      std::vector<bool> result;
+      for(aig::edge in : inputs) {
+        var_t v = var(in);
+        result.push_back(v != 0 && solver.value(v));
+      }
+      return result;
+    }
+
+    //
+    // The recursive abstraction refinement. A game is given by its levels,
+    // where the player to move chooses the moves at even levels and the 
+    // opponent the ones at odd levels, and by the matrix stating that the 
+    // player wins. The answer is a winning first move for the player, if 
+    // any. Refuted candidate moves and their counter-moves are recorded in 
+    // `learned`, if given.
+    //
+    struct rareqs {
+      std::optional<std::vector<bool>> solve(
+        levels_t const& levels, aig::edge matrix, 
+        cegar::refutations *learned
+      );
+      aig::edge assign(
+        levels_t const& levels, aig::edge matrix, 
+        std::vector<bool> const& move
+      );
+      aig::edge expand(
+        levels_t const& levels, aig::edge matrix, 
+        std::vector<bool> const& counter, levels_t &abstraction
+      );
+
+      aig &graph;
+      logic::alphabet &sigma;
+    };
+
+    // the matrix after the player's first move
+    aig::edge rareqs::assign(
+      levels_t const& levels, aig::edge matrix, std::vector<bool> const& move
+    ) {
+      std::unordered_map<size_t, aig::edge> map;
+      for(size_t j = 0; j < levels[0].size(); j++)
+        map.insert({aig::node(levels[0][j]), constant(move[j])});
+      for(size_t k = 1; k < levels.size(); k++)
+        for(aig::edge in : levels[k])
+          map.insert({aig::node(in), in});
+
+      return graph.copy(graph, matrix, map);
+    }
+
+    //
+    // The matrix after the opponent's counter-move, with fresh copies of the
+    // moves at the later levels, which are added to the abstraction. The 
+    // first moves of the player are shared by all the copies.
+    //
+    aig::edge rareqs::expand(
+      levels_t const& levels, aig::edge matrix, 
+      std::vector<bool> const& counter, levels_t &abstraction
+    ) {
+      std::unordered_map<size_t, aig::edge> map;
+      for(aig::edge in : levels[0])
+        map.insert({aig::node(in), in});
+      for(size_t j = 0; j < levels[1].size(); j++)
+        map.insert({aig::node(levels[1][j]), constant(counter[j])});
+      for(size_t k = 2; k < levels.size(); k++) {
+        for(aig::edge in : levels[k]) {
+          aig::edge fresh = graph.input();
+          map.insert({aig::node(in), fresh});
+          abstraction[k - 2].push_back(fresh);
+        }
+      }
+
+      return graph.copy(graph, matrix, map);
+    }
+
+    //
+    // The abstraction is the game where the opponent's first move is fixed 
+    // to each of the counter-moves found so far, so the player moves first
+    // in all the copies at once. A move winning the abstraction is only a 
+    // candidate, which is checked by solving the opponent's game after it.
+    // If the opponent wins, its winning move refines the abstraction. When 
+    // the abstraction or the opponent's game have a single level, they are 
+    // solved by an incremental SAT solver, the latter by assuming the 
+    // candidate move.
+    //
+    std::optional<std::vector<bool>> rareqs::solve(
+      levels_t const& levels, aig::edge matrix, cegar::refutations *learned
+    ) {
+      if(matrix == aig::bottom)
+        return {};
+      if(matrix == aig::top)
+        return std::vector<bool>(levels[0].size(), false);
+
+      if(levels.size() == 1) {
+        instance sat{graph, sigma};
+        sat.assert_true(matrix);
+        if(!sat.solve({}, {}))
+          return {};
+        return sat.model(levels[0]);
+      }
+
+      levels_t rest(levels.begin() + 1, levels.end());
+      levels_t abstraction(std::max(levels.size(), size_t{3}) - 2);
+      abstraction[0] = levels[0];
+      aig::edge abstract = aig::top;
+
+      std::optional<instance> candidates;
+      if(abstraction.size() == 1)
+        candidates.emplace(graph, sigma);
+
+      std::optional<instance> counters;
+      if(rest.size() == 1) {
+        counters.emplace(graph, sigma);
+        counters->assert_true(aig::negate(matrix));
+      }
+
+      auto refine = [&](std::vector<bool> const& counter) {
+        aig::edge e = expand(levels, matrix, counter, abstraction);
+        if(candidates)
+          candidates->assert_true(e);
+        else
+          abstract = graph.land(abstract, e);
+      };
+
+      if(learned)
+        for(std::vector<bool> const& counter : learned->moves)
+          refine(counter);
+
+      while(true) {
+        std::optional<std::vector<bool>> move;
+        if(candidates) {
+          if(candidates->solve({}, {}))
+            move = candidates->model(levels[0]);
+        } else {
+          move = solve(abstraction, abstract, nullptr);
+          if(move)
+            move->resize(levels[0].size());
+        }
+
+        if(!move)
+          return {};
+
+        std::optional<std::vector<bool>> counter;
+        if(counters) {
+          if(counters->solve(levels[0], *move))
+            counter = counters->model(levels[1]);
+        } else
+          counter = solve(
+            rest, aig::negate(assign(levels, matrix, *move)), 
+            learned ? learned->reply(*move) : nullptr
+          );
+
+        if(!counter)
+          return move;
+
+        if(learned)
+          learned->learn(*counter);
+        refine(*counter);
+      }
+    }
+
+    //
+    // The plays of the game up to bound n, over the outputs and the inputs 
+    // of each step, in this order. The state at each step is computed from
+    // the initial one and the moves before it.
+    //
+    struct plays {
+      plays(
+        automata const& aut, std::vector<bformula> const& next, 
+        std::vector<bool> const& init, size_t n
+      );
+
+      aig::edge eval(bformula f, size_t k);
+      aig::edge same(
+        std::vector<aig::edge> const& a, std::vector<aig::edge> const& b
+      );
+      aig::edge goal(size_t k, bool objective);
+      aig::edge repeats_state(size_t k);
+      aig::edge repeats_moves(size_t k);
+      aig::edge reach(bool objective);
+      aig::edge safety(bool objective, bool pairwise);
+
+      automata const& aut;
+      aig graph;
+      levels_t moves;
+      std::vector<std::vector<aig::edge>> states;
+    };
+
+    plays::plays(
+      automata const& a, std::vector<bformula> const& next, 
+      std::vector<bool> const& init, size_t n
+    ) : aut{a} {
+      std::vector<aig::edge> state;
+      for(bool value : init)
+        state.push_back(constant(value));
+      states.push_back(std::move(state));
+
+      for(size_t k = 0; k < n; k++) {
+        for(size_t size : {aut.outputs.size(), aut.inputs.size()}) {
+          std::vector<aig::edge> level;
+          for(size_t j = 0; j < size; j++)
+            level.push_back(graph.input());
+          moves.push_back(std::move(level));
+        }
+
+        std::vector<aig::edge> succ;
+        for(bformula def : next)
+          succ.push_back(eval(def, k));
+        states.push_back(std::move(succ));
+      }
+    }
+
+    // the value of f with the state of step k, and its moves if any
+    aig::edge plays::eval(bformula f, size_t k) {
+      std::unordered_map<proposition, aig::edge> values;
+      for(size_t j = 0; j < aut.variables.size(); j++)
+        values.insert({aut.variables[j], states[k][j]});
+      if(2 * k < moves.size()) {
+        for(size_t j = 0; j < aut.outputs.size(); j++)
+          values.insert({aut.outputs[j], moves[2 * k][j]});
+        for(size_t j = 0; j < aut.inputs.size(); j++)
+          values.insert({aut.inputs[j], moves[2 * k + 1][j]});
+      }
+
+      return to_aig(graph, f, [&](proposition p) {
+        auto it = values.find(p);
+        black_assert(it != values.end());
+        return it->second;
+      });
+    }
+
+    aig::edge plays::same(
+      std::vector<aig::edge> const& a, std::vector<aig::edge> const& b
+    ) {
+      aig::edge result = aig::top;
+      for(size_t j = 0; j < a.size(); j++)
+        result = graph.land(result, graph.iff(a[j], b[j]));
+      return result;
+    }
+
+    // whether the objective has the given value at step k
+    aig::edge plays::goal(size_t k, bool objective) {
+      aig::edge obj = eval(aut.objective, k);
+      return objective ? obj : aig::negate(obj);
+    }
+
+    aig::edge plays::repeats_state(size_t k) {
+      aig::edge result = aig::bottom;
+      for(size_t j = 0; j < k; j++)
+        result = graph.lor(result, same(states[k], states[j]));
+      return result;
+    }
+
+    aig::edge plays::repeats_moves(size_t k) {
+      aig::edge result = aig::bottom;
+      for(size_t j = 0; j < k; j++)
+        result = graph.lor(result, graph.land(
+          same(moves[2 * k], moves[2 * j]), 
+          same(moves[2 * k + 1], moves[2 * j + 1])
+        ));
+      return result;
+    }
+
+    // the objective takes the given value at some step
+    aig::edge plays::reach(bool objective) {
+      aig::edge result = aig::bottom;
+      for(size_t k = 0; k < states.size(); k++)
+        result = graph.lor(result, goal(k, objective));
+      return result;
+    }
+
+    //
+    // The objective keeps the given value until a lasso closes, following 
+    // the encoding of the lassos in the QBF queries: pairwise lassos close at
+    // steps before n where the inputs and the outputs repeat, and compact 
+    // ones at steps up to n where the state repeats.
+    //
+    aig::edge plays::safety(bool objective, bool pairwise) {
+      aig::edge result = aig::bottom;
+      aig::edge safe = aig::top;
+      for(size_t k = 0; k < states.size(); k++) {
+        if(pairwise) {
+          if(2 * k == moves.size())
+            break;
+          safe = graph.land(safe, goal(k, objective));
+          result = graph.lor(result, graph.land(safe, repeats_moves(k)));
+        } else {
+          result = graph.lor(result, graph.land(safe, repeats_state(k)));
+          safe = graph.land(safe, goal(k, objective));
+        }
+      }
+      return result;
+    }
+  }
+
+  cegar::cegar(
+    automata aut, game_t type, lasso_t lasso, logic::alphabet &sigma
+  ) : _aut{std::move(aut)}, _type{type}, _lasso{lasso}, _sigma{&sigma},
+      _next{next_state(_aut)}, _init{initial_state(_aut)},
+      _learned{{
+        std::make_shared<refutations>(), std::make_shared<refutations>()
+      }} { }
+
+  //
+  // The player moving first is the controller in both queries. In the 
+  // environment's one, it plays to avoid the environment's winning 
+  // condition, so the environment wins if the controller cannot.
+  //
+  std::array<black::tribool, 2> cegar::solve(size_t n) {
+    bool eventually = _type.match(
+      [](game_t::eventually) { return true; },
+      [](game_t::always) { return false; }
+    );
+    bool pairwise = _lasso == lasso_t::pairwise;
+
+    plays p{_aut, _next, _init, n};
+    
+    aig::edge controller = 
+      eventually ? p.reach(true) : p.safety(true, pairwise);
+    aig::edge environment = aig::negate(
+      eventually ? p.safety(false, pairwise) : p.reach(false)
+    );
+
+    rareqs r{p.graph, *_sigma};
+
+    if(r.solve(p.moves, controller, _learned[0].get()))
+      return {true, false};
+
+    bool avoided = r.solve(p.moves, environment, _learned[1].get()).has_value();
+    
+    return {false, !avoided};
+  }
+
+}
@@ -0,0 +1,208 @@
+//
+// Synthetico - Pure-past LTL synthesizer based on BLACK
+//
+// (C) 2023 Nicola Gigante
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#include "synthetico/synthetico.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace synth {
+
+  namespace {
+    //
+    // The query quantifies universally over a state s, the inputs and a 
+    // state s', and lets the outputs, the membership of s in the winning 
+    // region and its rank depend on s only. The membership and rank of s' 
+    // are given by other variables depending on s' only, which are forced 
+    // to agree with those of s whenever s = s', so that both copies are the
+    // same function. Tseitin variables depend on all the universal ones.
+    //
+    struct encoder {
+      encoder(automata aut, game_t type);
+
+      std::vector<aig::edge> inputs(size_t n);
+      aig::edge same(
+        std::vector<aig::edge> const& a, std::vector<aig::edge> const& b
+      );
+      aig::edge less(
+        std::vector<aig::edge> const& a, std::vector<aig::edge> const& b
+      );
+      qdimacs encode(clausifier_t clausifier);
+
+      automata aut;
+      game_t type;
+      automata_aig machine;
+      aig game;
+    };
+
+    encoder::encoder(automata a, game_t t)
+      : aut{std::move(a)}, type{t}, machine{to_aig(aut)} { }
+
+    std::vector<aig::edge> encoder::inputs(size_t n) {
+      std::vector<aig::edge> result;
+      for(size_t j = 0; j < n; j++)
+        result.push_back(game.input());
+      return result;
+    }
+
+    aig::edge encoder::same(
+      std::vector<aig::edge> const& a, std::vector<aig::edge> const& b
+    ) {
+      aig::edge result = aig::top;
+      for(size_t j = 0; j < a.size(); j++)
+        result = game.land(result, game.iff(a[j], b[j]));
+      return result;
+    }
+
+    // whether a < b as unsigned numbers, least significant bit first
+    aig::edge encoder::less(
+      std::vector<aig::edge> const& a, std::vector<aig::edge> const& b
+    ) {
+      aig::edge result = aig::bottom;
+      for(size_t j = 0; j < a.size(); j++)
+        result = game.lor(
+          game.land(aig::negate(a[j]), b[j]),
+          game.land(game.iff(a[j], b[j]), result)
+        );
+      return result;
+    }
+
+    qdimacs encoder::encode(clausifier_t clausifier) {
+      size_t n_state = aut.variables.size();
+      bool reach = type.match(
+        [](game_t::eventually) { return true; },
+        [](game_t::always) { return false; }
+      );
+
+      std::vector<aig::edge> state = inputs(n_state);
+      std::vector<aig::edge> ins = inputs(aut.inputs.size());
+      std::vector<aig::edge> outs = inputs(aut.outputs.size());
+      std::vector<aig::edge> next = inputs(n_state);
+      aig::edge region = game.input();
+      aig::edge next_region = game.input();
+      std::vector<aig::edge> rank = inputs(reach ? n_state : 0);
+      std::vector<aig::edge> next_rank = inputs(reach ? n_state : 0);
+
+      // the input nodes of the machine are, in order, the state variables, 
+      // the inputs, the outputs and the primed state variables
+      std::unordered_map<size_t, aig::edge> map;
+      size_t slot = 1;
+      for(auto const *group : {&state, &ins, &outs, &next})
+        for(aig::edge e : *group)
+          map.insert({slot++, e});
+
+      aig::edge init = game.copy(machine.graph, machine.init, map);
+      aig::edge trans = game.copy(machine.graph, machine.trans, map);
+      aig::edge objective = game.copy(machine.graph, machine.objective, map);
+
+      aig::edge step = game.land(region, trans);
+      aig::edge progress = reach
+        ? game.implies(
+            game.land(step, aig::negate(objective)), 
+            game.land(next_region, less(next_rank, rank))
+          )
+        : game.implies(step, game.land(objective, next_region));
+
+      aig::edge agree = game.implies(
+        same(state, next), 
+        game.land(game.iff(region, next_region), same(rank, next_rank))
+      );
+
+      aig::edge root = game.land(
+        game.land(game.implies(init, region), progress), agree
+      );
+
+      std::vector<var_t> vars(game.size(), 0);
+      var_t n = 1;
+      auto number = [&](std::vector<aig::edge> const& group) {
+        std::vector<var_t> result;
+        for(aig::edge e : group) {
+          vars[aig::node(e)] = n;
+          result.push_back(n++);
+        }
+        return result;
+      };
+
+      std::vector<var_t> current = number(state);
+      std::vector<var_t> in_vars = number(ins);
+      std::vector<var_t> primed = number(next);
+
+      std::vector<var_t> universals = current;
+      universals.insert(universals.end(), in_vars.begin(), in_vars.end());
+      universals.insert(universals.end(), primed.begin(), primed.end());
+
+      std::vector<std::pair<var_t, std::vector<var_t>>> dependencies;
+      for(auto const& group : {outs, std::vector{region}, rank})
+        for(var_t v : number(group))
+          dependencies.push_back({v, current});
+      for(auto const& group : {std::vector{next_region}, next_rank})
+        for(var_t v : number(group))
+          dependencies.push_back({v, primed});
+
+      var_t first = n;
+      clause_list clauses;
+      clausify(game, std::span{&root, 1}, clausifier, vars, n, clauses);
+
+      std::vector<var_t> tseitin;
+      for(var_t v = first; v < n; v++)
+        tseitin.push_back(v);
+
+      std::vector<qdimacs_block> blocks = {
+        {qdimacs_block::universal, std::move(universals)},
+        {qdimacs_block::existential, std::move(tseitin)}
+      };
+
+      // the variables stand for AIG nodes, not for propositions
+      return qdimacs{
+        n - 1, std::move(blocks), std::move(clauses), {}, {}, 
+        std::move(dependencies)
+      };
+    }
+  }
+
+  black::tribool is_realizable_dqbf(spec sp, qbf_options const& opts) {
+    encoder enc{encode(sp), sp.type};
+    qdimacs qd = enc.encode(opts.clausifier);
+
+    limits_t limits = opts.limits;
+    if(opts.timeout)
+      limits.timeout = 
+        limits.timeout ? std::min(*limits.timeout, *opts.timeout) 
+                       : *opts.timeout;
+
+    std::optional<cache> results;
+    if(opts.cache_dir)
+      results.emplace(*opts.cache_dir);
+
+    query q{qd, opts.backend, limits, results ? &*results : nullptr};
+    
+    return q.result();
+  }
+
+}
@@ -0,0 +1,237 @@
+//
+// Synthetico - Pure-past LTL synthesizer based on BLACK
+//
+// (C) 2023 Nicola Gigante
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#include "synthetico/synthetico.hpp"
+
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace synth {
+
+  namespace {
+    //
+    // The expansion is built depth-first. Along the current history, `path`
+    // holds the state, the outputs and the inputs of each step. Each node 
+    // of the tree yields the winning condition of the controller from that 
+    // node on, and the negation of the one of the environment.
+    //
+    struct tree {
+      struct frame {
+        std::vector<aig::edge> state;
+        std::vector<aig::edge> outputs;
+        size_t inputs = 0;
+      };
+
+      aig::edge eval(bformula f, frame const& at);
+      aig::edge same(
+        std::vector<aig::edge> const& a, std::vector<aig::edge> const& b
+      );
+      aig::edge repeats_state(std::vector<aig::edge> const& state);
+      aig::edge repeats_moves(frame const& at);
+      std::pair<aig::edge, aig::edge> visit(std::vector<aig::edge> state);
+
+      automata const& aut;
+      std::vector<bformula> const& next;
+      bool eventually;
+      bool pairwise;
+      size_t n;
+
+      aig graph;
+      std::vector<frame> path;
+    };
+
+    // the value of f with the inputs, outputs and state of the given step
+    aig::edge tree::eval(bformula f, frame const& at) {
+      std::unordered_map<proposition, aig::edge> values;
+      for(size_t j = 0; j < aut.variables.size(); j++)
+        values.insert({aut.variables[j], at.state[j]});
+      for(size_t j = 0; j < at.outputs.size(); j++)
+        values.insert({aut.outputs[j], at.outputs[j]});
+      for(size_t j = 0; j < aut.inputs.size(); j++)
+        values.insert({
+          aut.inputs[j], ((at.inputs >> j) & 1) ? aig::top : aig::bottom
+        });
+
+      return to_aig(graph, f, [&](proposition p) {
+        auto it = values.find(p);
+        black_assert(it != values.end());
+        return it->second;
+      });
+    }
+
+    aig::edge tree::same(
+      std::vector<aig::edge> const& a, std::vector<aig::edge> const& b
+    ) {
+      aig::edge result = aig::top;
+      for(size_t j = 0; j < a.size(); j++)
+        result = graph.land(result, graph.iff(a[j], b[j]));
+      return result;
+    }
+
+    // whether the state was already visited along the current history
+    aig::edge tree::repeats_state(std::vector<aig::edge> const& state) {
+      aig::edge result = aig::bottom;
+      for(frame const& f : path)
+        result = graph.lor(result, same(state, f.state));
+      return result;
+    }
+
+    // whether the moves of the last step were already played before
+    aig::edge tree::repeats_moves(frame const& at) {
+      aig::edge result = aig::bottom;
+      for(size_t j = 0; j + 1 < path.size(); j++)
+        if(path[j].inputs == at.inputs)
+          result = graph.lor(result, same(at.outputs, path[j].outputs));
+      return result;
+    }
+
+    //
+    // In reachability games the winner must meet the objective along all 
+    // the histories. In safety games the winner must close a lasso while 
+    // meeting the objective, following the encoding of the lassos in the 
+    // QBF queries: pairwise lassos close at steps before n where the inputs 
+    // and the outputs repeat, and compact ones at steps up to n where the 
+    // state repeats.
+    //
+    std::pair<aig::edge, aig::edge> tree::visit(std::vector<aig::edge> state) 
+    {
+      aig::edge obj = eval(aut.objective, frame{state, {}, 0});
+      aig::edge loop = pairwise ? aig::bottom : repeats_state(state);
+
+      if(path.size() == n) {
+        if(eventually)
+          return {obj, pairwise ? aig::top : aig::negate(loop)};
+        return {pairwise ? aig::bottom : loop, obj};
+      }
+
+      std::vector<aig::edge> outputs;
+      for(size_t j = 0; j < aut.outputs.size(); j++)
+        outputs.push_back(graph.input());
+
+      path.push_back(frame{state, outputs, 0});
+      
+      aig::edge controller = aig::top;
+      aig::edge environment = aig::top;
+      for(size_t x = 0; x < (size_t{1} << aut.inputs.size()); x++) {
+        path.back().inputs = x;
+
+        std::vector<aig::edge> succ;
+        for(bformula def : next)
+          succ.push_back(eval(def, path.back()));
+
+        auto [c, e] = visit(std::move(succ));
+        aig::edge moves = pairwise ? repeats_moves(path.back()) : aig::bottom;
+
+        if(eventually) {
+          controller = graph.land(controller, c);
+          environment = graph.land(
+            environment, graph.land(aig::negate(moves), e)
+          );
+        } else {
+          controller = graph.land(controller, graph.lor(moves, c));
+          environment = graph.land(environment, e);
+        }
+      }
+      
+      path.pop_back();
+
+      if(eventually) {
+        aig::edge e = graph.lor(obj, environment);
+        return {
+          graph.lor(obj, controller), 
+          pairwise ? e : graph.land(aig::negate(loop), e)
+        };
+      }
+
+      aig::edge c = graph.land(obj, controller);
+      return {
+        pairwise ? c : graph.lor(loop, c), 
+        graph.land(obj, environment)
+      };
+    }
+  }
+
+  expansion::expansion(
+    automata aut, game_t type, lasso_t lasso, logic::alphabet &sigma
+  ) : _aut{std::move(aut)}, _type{type}, _lasso{lasso}, _sigma{&sigma},
+      _next{next_state(_aut)} { }
+
+  std::array<black::tribool, 2> expansion::solve(size_t n) {
+    bool eventually = _type.match(
+      [](game_t::eventually) { return true; },
+      [](game_t::always) { return false; }
+    );
+
+    tree t{_aut, _next, eventually, _lasso == lasso_t::pairwise, n, {}, {}};
+
+    std::vector<aig::edge> init;
+    for(size_t j = 0; j < _aut.variables.size(); j++)
+      init.push_back(t.graph.input());
+    aig::edge start = t.eval(_aut.init, tree::frame{init, {}, 0});
+
+    auto [controller, environment] = t.visit(init);
+
+    // each player's condition is enabled by assuming its selector
+    std::array<aig::edge, 2> selectors = {t.graph.input(), t.graph.input()};
+    std::array<aig::edge, 3> roots = {
+      start, 
+      t.graph.implies(selectors[0], controller),
+      t.graph.implies(selectors[1], environment)
+    };
+
+    std::vector<var_t> vars(t.graph.size(), 0);
+    var_t next = 1;
+    for(size_t node = 1; node < t.graph.size(); node++)
+      if(t.graph.is_input(node))
+        vars[node] = next++;
+
+    clause_list clauses;
+    clausify(t.graph, roots, clausifier_t::polarity, vars, next, clauses);
+
+    sat_solver solver{*_sigma};
+    solver.add(clauses);
+
+    std::array<lit_t, 2> assumptions = {
+      lit_t(vars[aig::node(selectors[0])]), 
+      lit_t(vars[aig::node(selectors[1])])
+    };
+
+    black::tribool controller_wins = 
+      solver.solve(std::span{&assumptions[0], 1});
+    black::tribool environment_avoided = 
+      solver.solve(std::span{&assumptions[1], 1});
+    
+    black::tribool environment_wins = black::tribool::undef;
+    if(environment_avoided == true)
+      environment_wins = false;
+    else if(environment_avoided == false)
+      environment_wins = true;
+
+    return {controller_wins, environment_wins};
+  }
+
+}
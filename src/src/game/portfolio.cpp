@@ -0,0 +1,94 @@
+//
+// Synthetico - Pure-past LTL synthesizer based on BLACK
+//
+// (C) 2023 Nicola Gigante
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#include "synthetico/synthetico.hpp"
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+namespace synth {
+
+  namespace {
+    struct engine {
+      std::string name;
+      std::function<black::tribool(spec)> solve;
+    };
+  }
+
+  static std::string verdict(black::tribool result) {
+    if(result == true)
+      return "REALIZABLE";
+    if(result == false)
+      return "UNREALIZABLE";
+    return "UNKNOWN";
+  }
+
+  static black::tribool parse_verdict(std::string const& output) {
+    std::istringstream lines(output);
+    std::string line;
+    while(std::getline(lines, line)) {
+      if(line == "REALIZABLE")
+        return true;
+      if(line == "UNREALIZABLE")
+        return false;
+    }
+    return black::tribool::undef;
+  }
+
+  portfolio_result is_realizable_portfolio(spec sp, qbf_options const& opts) {
+    std::vector<engine> engines = {
+      {"qbf", [&](spec s) { return is_realizable_qbf(s, opts); }},
+      {"bdd", [](spec s) { return is_realizable_bdd(s); }}
+    };
+
+    // Each engine works on its own copy of the alphabet and of the CUDD
+    // manager, since they live in different address spaces.
+    std::vector<std::unique_ptr<process>> workers;
+    for(auto const& e : engines) {
+      workers.push_back(std::make_unique<process>([&]() {
+        std::cout << verdict(e.solve(sp)) << "\n";
+        return 0;
+      }));
+    }
+
+    std::vector<process *> pending;
+    for(auto const& w : workers)
+      pending.push_back(w.get());
+
+    while(true) {
+      size_t i = process::wait_any(pending);
+      if(i == pending.size())
+        return {};
+
+      pending[i] = nullptr;
+      black::tribool result = parse_verdict(workers[i]->output());
+      if(result == true || result == false)
+        return { result, engines[i].name };
+    }
+  }
+
+}
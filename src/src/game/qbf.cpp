@@ -25,9 +25,25 @@
 #include "synthetico/synthetico.hpp"
 
 #include <black/logic/prettyprint.hpp>
-#include <black/support/range.hpp>
 
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <stop_token>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include <iostream>
 
 namespace synth {
@@ -38,25 +54,163 @@ namespace synth {
   };
 
   namespace {
+    //
+    // The clauses of the unrolling up to some bound, i.e. the copies of the
+    // transition relation and the initial condition, shared by the queries of
+    // both players, which use variables 1 to n_vars.
+    //
+    struct unrolling {
+      std::shared_ptr<clause_list const> clauses;
+      var_t n_vars;
+    };
+
+    //
+    // The unrolling of the game is built directly on QDIMACS variables. Step
+    // k takes up variables k * width + 1 to (k + 1) * width: first the state
+    // variables, then the inputs, the outputs, and the Tseitin variables of
+    // the transition relation, which is clausified once as a template (see
+    // `clause_template`). The winning conditions of both players are built
+    // incrementally in an and-inverter graph over the variables of the 
+    // unrolling, shared across bounds.
+    //
     struct encoder {
 
-      bformula win(player_t player, game_t type, size_t n);
-      bformula unravel(size_t n);
+      encoder(
+        automata aut, game_t type, clausifier_t clausifier, lasso_t lasso
+      );
+
+      aig::edge atom(size_t slot, size_t k);
+      aig::edge looping(size_t k);
+      aig::edge objective(size_t k);
+      bool reach(player_t player) const;
+      aig::edge goal(player_t player, size_t k);
+      aig::edge win(player_t player, size_t n);
 
-      qbformula encode(player_t player, game_t type, size_t n);
+      unrolling unravel(size_t n);
+      qdimacs encode(player_t player, size_t n, unrolling const& u);
 
-      logic::alphabet &sigma;
       automata aut;
+      game_t type;
+      clausifier_t clausifier;
+      lasso_t lasso;
+      automata_aig machine;
+      size_t n_state;
+      size_t n_atoms;
+      clause_template trans;
+
+      aig game;
+      std::vector<aig::edge> atoms; // indexed by variable - 1
+      std::vector<var_t> vars; // indexed by node of `game`
+      std::vector<aig::edge> objectives;
+      std::array<std::vector<aig::edge>, 2> goals;
+
+      // for compact lassos, the guessed loop state, whether each step is in 
+      // it, and for each player whether the objective held and whether the 
+      // loop state was visited before the last goal
+      std::vector<aig::edge> loop_state;
+      std::vector<aig::edge> loops;
+      std::array<aig::edge, 2> safe = {aig::top, aig::top};
+      std::array<aig::edge, 2> visited = {aig::bottom, aig::bottom};
 
     };
 
-    bformula encoder::win(player_t player, game_t type, size_t n) {
-      using namespace logic;
+    //
+    // The primed state variables are first numbered right after the atoms of
+    // the step, and the Tseitin variables after them. The former are then 
+    // moved to the next step.
+    //
+    clause_template transition(
+      automata_aig const& m, size_t n_state, size_t n_atoms, 
+      clausifier_t clausifier
+    ) {
+      std::vector<var_t> vars(m.graph.size(), 0);
+      for(size_t j = 1; j <= n_atoms + n_state; j++)
+        vars[j] = var_t(j);
+      var_t next = var_t(n_atoms + n_state + 1);
+
+      clause_list clauses;
+      clausify(
+        m.graph, std::span{&m.trans, 1}, clausifier, vars, next, clauses
+      );
+
+      clause_template result{next - 1 - n_state, n_state, {}};
+      result.clauses.reserve(clauses.size(), clauses.n_literals());
+      for(clause cl : clauses) {
+        for(lit_t lit : cl) {
+          size_t v = size_t(std::abs(lit));
+          if(v > n_atoms + n_state)
+            v -= n_state;
+          else if(v > n_atoms)
+            v += result.width - n_atoms;
+          
+          result.clauses.add(lit < 0 ? -lit_t(v) : lit_t(v));
+        }
+        result.clauses.close();
+      }
+
+      return result;
+    }
+
+    encoder::encoder(automata a, game_t t, clausifier_t c, lasso_t l)
+      : aut{std::move(a)}, type{t}, clausifier{c}, lasso{l}, 
+        machine{to_aig(aut)},
+        n_state{aut.variables.size()},
+        n_atoms{n_state + aut.inputs.size() + aut.outputs.size()},
+        trans{transition(machine, n_state, n_atoms, clausifier)} { }
+
+    aig::edge encoder::atom(size_t slot, size_t k) {
+      size_t var = k * trans.width + slot + 1;
+      if(atoms.size() < var)
+        atoms.resize(var, aig::bottom);
+
+      if(atoms[var - 1] == aig::bottom) {
+        atoms[var - 1] = game.input();
+        vars.resize(game.size(), 0);
+        vars[aig::node(atoms[var - 1])] = var_t(var);
+      }
+
+      return atoms[var - 1];
+    }
+
+    //
+    // Whether the state at step k is the loop state, which is guessed by 
+    // inputs of the graph quantified after all the steps.
+    //
+    aig::edge encoder::looping(size_t k) {
+      if(loop_state.size() < n_state) {
+        for(size_t s = 0; s < n_state; s++)
+          loop_state.push_back(game.input());
+        vars.resize(game.size(), 0);
+      }
+
+      while(loops.size() <= k) {
+        size_t i = loops.size();
+
+        aig::edge same = aig::top;
+        for(size_t s = 0; s < n_state; s++)
+          same = game.land(same, game.iff(atom(s, i), loop_state[s]));
+        loops.push_back(same);
+      }
+
+      return loops[k];
+    }
+
+    aig::edge encoder::objective(size_t k) {
+      while(objectives.size() <= k) {
+        size_t i = objectives.size();
+        
+        std::unordered_map<size_t, aig::edge> map;
+        for(size_t s = 0; s < n_atoms; s++)
+          map.insert({s + 1, atom(s, i)});
+        
+        objectives.push_back(game.copy(machine.graph, machine.objective, map));
+      }
 
-      bformula objective = 
-        player == player_t::controller ? aut.objective : !aut.objective;
+      return objectives[k];
+    }
 
-      bool reach = type.match(
+    bool encoder::reach(player_t player) const {
+      return type.match(
         [&](game_t::eventually) {
           return player == player_t::controller;
         },
@@ -64,71 +218,315 @@ namespace synth {
           return player == player_t::environment;
         }
       );
+    }
 
-      if(reach)
-        return big_or(sigma, black::range(0, n + 1), [&](auto i) {
-          return stepped(objective, i);
-        });
-      
-      return big_or(sigma, black::range(0, n), [&](auto k) {
-        auto loop = big_or(sigma, black::range(0, k), [&](auto j) {
-          auto ell = [&](auto p) {
-            return iff(stepped(p, k), stepped(p, j));
-          };
-          return 
-            big_and(sigma, aut.inputs, ell) &&
-            big_and(sigma, aut.outputs, ell);
-        });
-
-        auto safety = big_and(sigma, black::range(0, k + 1), [&](auto w) {
-          return stepped(objective, w);
-        });
-
-        return loop && safety;
-      });
+    //
+    // The disjunct of the winning condition for the objective being met at 
+    // step k in reachability games, or for a lasso closing at step k in 
+    // safety games. Pairwise lassos close when the inputs and outputs at 
+    // step k repeat those of an earlier step, and the objective held up to 
+    // step k. Compact lassos close when the state at step k is the loop state
+    // and was already visited, and the objective held before step k.
+    //
+    aig::edge encoder::goal(player_t player, size_t k) {
+      auto &defs = goals[size_t(player)];
+      while(defs.size() <= k) {
+        size_t i = defs.size();
+        
+        auto obj = [&](size_t w) {
+          aig::edge o = objective(w);
+          return player == player_t::controller ? o : aig::negate(o);
+        };
+
+        if(reach(player)) {
+          defs.push_back(obj(i));
+          continue;
+        }
+
+        if(lasso == lasso_t::compact) {
+          size_t p = size_t(player);
+          defs.push_back(
+            game.land(game.land(looping(i), visited[p]), safe[p])
+          );
+          visited[p] = game.lor(visited[p], looping(i));
+          safe[p] = game.land(safe[p], obj(i));
+          continue;
+        }
+
+        aig::edge loop = aig::bottom;
+        for(size_t j = 0; j < i; j++) {
+          aig::edge same = aig::top;
+          for(size_t s = n_state; s < n_atoms; s++)
+            same = game.land(same, game.iff(atom(s, i), atom(s, j)));
+          loop = game.lor(loop, same);
+        }
+
+        aig::edge safety = aig::top;
+        for(size_t w = 0; w <= i; w++)
+          safety = game.land(safety, obj(w));
+
+        defs.push_back(game.land(loop, safety));
+      }
+
+      return defs[k];
     }
 
-    bformula encoder::unravel(size_t n) {
-      return 
-        stepped(aut.init, 0) &&
-        big_and(sigma, black::range(0, n), [&](auto i) {
-          return stepped(aut.trans, i);
-        });
+    //
+    // The disjunction of the goals up to step n for reachability, and of the
+    // lassos closing before step n for safety, or up to step n if compact, 
+    // since their last step only needs the state.
+    //
+    aig::edge encoder::win(player_t player, size_t n) {
+      size_t last = 
+        reach(player) || lasso == lasso_t::compact ? n + 1 : n;
+
+      aig::edge result = aig::bottom;
+      for(size_t k = 0; k < last; k++)
+        result = game.lor(result, goal(player, k));
+
+      return result;
     }
 
-    qbformula encoder::encode(player_t player, game_t type, size_t n) 
-    {
-      using namespace logic::fragments::QBF;
+    unrolling encoder::unravel(size_t n) {
+      auto clauses = std::make_shared<clause_list>();
+      unroll(trans, n, *clauses);
 
-      qbformula result = thereis(stepped(aut.variables, n), 
-        unravel(n) && win(player, type, n)
+      std::vector<var_t> init_vars(machine.graph.size(), 0);
+      for(size_t j = 1; j <= n_atoms; j++)
+        init_vars[j] = var_t(j);
+      var_t next = var_t(n * trans.width + n_state + 1);
+      
+      clausify(
+        machine.graph, std::span{&machine.init, 1}, clausifier, 
+        init_vars, next, *clauses
       );
 
+      return unrolling{std::move(clauses), next - 1};
+    }
+
+    //
+    // Only the quantifier prefix and the winning condition are specific to
+    // each player. The latter is clausified on top of the unrolling.
+    //
+    qdimacs encoder::encode(player_t player, size_t n, unrolling const& u) 
+    {
+      aig::edge w = win(player, n);
+      
+      std::vector<var_t> win_vars = vars;
+      win_vars.resize(game.size(), 0);
+      var_t next = u.n_vars + 1;
+
+      // the loop state is quantified together with the Tseitin variables
+      if(!reach(player))
+        for(aig::edge e : loop_state)
+          win_vars[aig::node(e)] = next++;
+
+      clause_list clauses{u.clauses};
+      clausify(game, std::span{&w, 1}, clausifier, win_vars, next, clauses);
+      var_t n_vars = next - 1;
+
       // defaults for Controller
-      std::vector<proposition> first = aut.outputs;
-      std::vector<proposition> second = aut.inputs;
-      quantifier_t qfirst = quantifier_t::thereis{};
-      quantifier_t qsecond = quantifier_t::foreach{};
+      auto qfirst = qdimacs_block::existential;
+      auto qsecond = qdimacs_block::universal;
 
       if(player == player_t::environment) {
-        first = aut.outputs;
-        second = aut.inputs;
-        qfirst = quantifier_t::foreach{};
-        qsecond = quantifier_t::thereis{};
+        qfirst = qdimacs_block::universal;
+        qsecond = qdimacs_block::existential;
       }
 
+      auto range = [](size_t first, size_t count) {
+        std::vector<var_t> result(count);
+        std::iota(result.begin(), result.end(), var_t(first));
+        return result;
+      };
+
+      size_t width = trans.width;
+      size_t n_inputs = aut.inputs.size();
+      size_t n_outputs = aut.outputs.size();
+      
+      std::vector<qdimacs_block> blocks;
+      std::vector<var_t> tseitin;
       for(size_t i = 0; i < n; i++) {
-        size_t step = n - i - 1;
+        size_t base = i * width + 1;
+        blocks.push_back({qdimacs_block::existential, range(base, n_state)});
+        blocks.push_back({qfirst, range(base + n_state + n_inputs, n_outputs)});
+        blocks.push_back({qsecond, range(base + n_state, n_inputs)});
         
-        result = 
-          thereis(stepped(aut.variables, step),
-            qbf(qfirst, stepped(first, step),
-              qbf(qsecond, stepped(second, step),
-                result
-              )
-            )
-          );
+        for(var_t v : range(base + n_atoms, width - n_atoms))
+          tseitin.push_back(v);
+      }
+      blocks.push_back({
+        qdimacs_block::existential, range(n * width + 1, n_state)
+      });
+
+      // quantifiers for Tseitin variables
+      size_t unrolled = n * width + n_state;
+      for(var_t v : range(unrolled + 1, n_vars - unrolled))
+        tseitin.push_back(v);
+
+      if(!tseitin.empty())
+        blocks.push_back({qdimacs_block::existential, std::move(tseitin)});
+
+      // the variables stand for AIG nodes, not for propositions
+      return qdimacs{
+        n_vars, std::move(blocks), std::move(clauses), {}, {}, {}
+      };
+    }
+  }
+
+  namespace {
+    //
+    // The query of one player kept in a single backend instance across 
+    // bounds. The steps of the unrolling are added as the bound grows, 
+    // while the winning condition of each bound is guarded by a selector, 
+    // which is assumed while solving at that bound and then disabled for 
+    // good. The variables of the backend are numbered as they are declared,
+    // so `ids` translates the variables of the unrolling (see `encoder`).
+    //
+    struct stepwise {
+      stepwise(encoder &e, player_t p, backend_t backend);
+
+      std::vector<var_t> declare(size_t first, size_t count);
+      var_t id(var_t var) const;
+      void extend(size_t n);
+      black::tribool solve(size_t n);
+
+      encoder &enc;
+      player_t player;
+      incremental_solver solver;
+      std::vector<var_t> ids; // indexed by variable - 1
+      var_t next = 1;
+      size_t steps = 0;
+    };
+
+    // the initial state and the initial condition
+    stepwise::stepwise(encoder &e, player_t p, backend_t backend)
+      : enc{e}, player{p}, solver{backend} 
+    {
+      std::vector<var_t> state = declare(1, enc.n_state);
+      black_assert(!state.empty());
+      solver.add({qdimacs_block::existential, state});
+
+      std::vector<var_t> init_vars(enc.machine.graph.size(), 0);
+      for(size_t j = 1; j <= enc.n_state; j++)
+        init_vars[j] = state[j - 1];
+      
+      var_t first = next;
+      clause_list clauses;
+      clausify(
+        enc.machine.graph, std::span{&enc.machine.init, 1}, enc.clausifier,
+        init_vars, next, clauses
+      );
+
+      std::vector<var_t> tseitin(next - first);
+      std::iota(tseitin.begin(), tseitin.end(), first);
+      solver.add({qdimacs_block::existential, std::move(tseitin)});
+      for(clause cl : clauses)
+        solver.add(cl);
+    }
+
+    std::vector<var_t> stepwise::declare(size_t first, size_t count) {
+      if(ids.size() < first + count - 1)
+        ids.resize(first + count - 1, 0);
+
+      std::vector<var_t> result;
+      for(size_t v = first; v < first + count; v++) {
+        black_assert(ids[v - 1] == 0);
+        ids[v - 1] = next++;
+        result.push_back(ids[v - 1]);
+      }
+      return result;
+    }
+
+    var_t stepwise::id(var_t var) const {
+      black_assert(var <= ids.size() && ids[var - 1] != 0);
+      return ids[var - 1];
+    }
+
+    //
+    // Step k brings the moves of step k, the state of step k + 1, and the 
+    // Tseitin variables of the transition in between, with the same 
+    // quantifiers as in `encoder::encode`.
+    //
+    void stepwise::extend(size_t n) {
+      auto qfirst = qdimacs_block::existential;
+      auto qsecond = qdimacs_block::universal;
+      if(player == player_t::environment)
+        std::swap(qfirst, qsecond);
+
+      size_t width = enc.trans.width;
+      size_t n_inputs = enc.aut.inputs.size();
+      size_t n_outputs = enc.aut.outputs.size();
+
+      for(; steps < n; steps++) {
+        size_t base = steps * width + 1;
+        std::vector<var_t> outputs = 
+          declare(base + enc.n_state + n_inputs, n_outputs);
+        std::vector<var_t> inputs = declare(base + enc.n_state, n_inputs);
+        std::vector<var_t> after = declare(base + width, enc.n_state);
+        std::vector<var_t> tseitin = 
+          declare(base + enc.n_atoms, width - enc.n_atoms);
+        after.insert(after.end(), tseitin.begin(), tseitin.end());
+
+        solver.add({qfirst, std::move(outputs)});
+        solver.add({qsecond, std::move(inputs)});
+        solver.add({qdimacs_block::existential, std::move(after)});
+
+        std::vector<lit_t> lits;
+        for(clause cl : enc.trans.clauses) {
+          lits.clear();
+          for(lit_t lit : cl) {
+            var_t v = id(var_t(std::abs(lit)) + var_t(steps * width));
+            lits.push_back(lit < 0 ? -lit_t(v) : lit_t(v));
+          }
+          solver.add(lits);
+        }
       }
+    }
+
+    //
+    // The winning condition is clausified with its own Tseitin variables, 
+    // and its own copy of the loop state if any, since the ones of earlier
+    // bounds end up quantified before the later steps. They are declared 
+    // innermost, where the later steps then follow.
+    //
+    black::tribool stepwise::solve(size_t n) {
+      extend(n);
+
+      aig::edge w = enc.win(player, n);
+
+      std::vector<var_t> win_vars(enc.game.size(), 0);
+      for(size_t node = 0; node < enc.vars.size(); node++)
+        if(enc.vars[node] != 0 && enc.vars[node] <= ids.size())
+          win_vars[node] = ids[enc.vars[node] - 1];
+
+      var_t first = next;
+      if(!enc.reach(player))
+        for(aig::edge e : enc.loop_state)
+          win_vars[aig::node(e)] = next++;
+
+      clause_list clauses;
+      clausify(enc.game, std::span{&w, 1}, enc.clausifier, win_vars, next, 
+        clauses);
+      
+      var_t selector = next++;
+      std::vector<var_t> tseitin(selector - first);
+      std::iota(tseitin.begin(), tseitin.end(), first);
+      solver.add({qdimacs_block::existential, std::move(tseitin)});
+      solver.add_outermost(selector);
+
+      std::vector<lit_t> lits;
+      for(clause cl : clauses) {
+        lits.assign(cl.begin(), cl.end());
+        lits.push_back(-lit_t(selector));
+        solver.add(lits);
+      }
+
+      lit_t on = lit_t(selector);
+      black::tribool result = solver.solve(std::span{&on, 1});
+
+      lit_t off = -lit_t(selector);
+      solver.add(std::span{&off, 1});
 
       return result;
     }
@@ -136,39 +534,560 @@ namespace synth {
 
   static constexpr bool debug = false;
 
-  black::tribool is_realizable_qbf(spec sp) {
+  static black::tribool unknown(std::optional<size_t> decided) {
+    if(decided)
+      std::cerr << "No winner up to bound n = " << *decided << "\n";
+    else
+      std::cerr << "No bound could be decided\n";
+    
+    return black::tribool::undef;
+  }
+
+  namespace {
+    //
+    // The two queries of a bound, which is settled when both of them have
+    // answered, or as soon as the controller wins. Both players might win at
+    // the same bound, and then the controller prevails, as if it were asked
+    // first, so a win of the environment has to wait for the controller's
+    // answer.
+    //
+    struct attempt {
+      size_t n = 0;
+      std::array<std::optional<query>, 2> queries;
+      size_t answered = 0;
+      size_t refuted = 0;
+      std::optional<player_t> winner;
+
+      bool settled() const {
+        return (winner && !queries[0]) || answered == queries.size();
+      }
+    };
+
+    constexpr std::array players = {
+      player_t::controller, player_t::environment
+    };
+
+    //
+    // Encodes the queries of consecutive bounds, starting from the first 
+    // one, in a background thread, so that encoding a bound overlaps with 
+    // solving the earlier ones. At most `opts.lookahead` bounds past the 
+    // last one taken are encoded, counting the one in progress. The encoder,
+    // and the statistics if queries are preprocessed, belong to the thread 
+    // until the pipeline is destroyed. Destroying it stops the thread, which
+    // checks for that between the stages of the encoding, and in between 
+    // the rounds of preprocessing, so the search does not wait long for a 
+    // bound it does not need.
+    //
+    struct pipeline {
+      pipeline(
+        encoder &enc, qbf_options const& opts, preprocess_stats &stats,
+        size_t first, std::optional<size_t> last
+      );
+      pipeline(pipeline const&) = delete;
+      ~pipeline();
+
+      pipeline &operator=(pipeline const&) = delete;
 
-    logic::alphabet &sigma = *sp.formula.sigma();
+      std::vector<qdimacs> take(size_t n);
 
-    automata aut = encode(sp);
+      void run(std::stop_token stop);
 
-    if(debug)
-      std::cerr << aut << "\n";
+      encoder &enc;
+      qbf_options const& opts;
+      preprocess_stats &stats;
+      size_t first;
+      size_t next; // the next bound to be taken
+      std::optional<size_t> last;
 
-    size_t n = 3;
-    while(true) {
-      qbformula formulaC = 
-        encoder{sigma, aut}.encode(player_t::controller, sp.type, n);
-      qdimacs qdC = clausify(formulaC);
+      std::mutex lock;
+      std::condition_variable_any changed;
+      std::deque<std::vector<qdimacs>> ready;
+      std::exception_ptr error;
+      bool finished = false;
+      std::jthread worker;
+    };
+
+    pipeline::pipeline(
+      encoder &e, qbf_options const& o, preprocess_stats &st,
+      size_t f, std::optional<size_t> l
+    ) : enc{e}, opts{o}, stats{st}, first{f}, next{f}, last{l}, 
+        worker{[this](std::stop_token stop) { run(stop); }} { }
+
+    pipeline::~pipeline() {
+      worker.request_stop();
+      worker.join();
+    }
+
+    void pipeline::run(std::stop_token stop) {
+      try {
+        for(size_t n = first; !last || n <= *last; n++) {
+          {
+            std::unique_lock guard{lock};
+            bool room = changed.wait(guard, stop, [&]() {
+              return n < next + opts.lookahead;
+            });
+            if(!room)
+              break;
+          }
+
+          unrolling u = enc.unravel(n);
+          std::vector<qdimacs> queries;
+          for(player_t p : players) {
+            if(stop.stop_requested())
+              break;
+            qdimacs qd = enc.encode(p, n, u);
+            if(opts.preprocess)
+              qd = preprocess(qd, stats, stop);
+            queries.push_back(std::move(qd));
+          }
+          if(stop.stop_requested())
+            break;
+
+          std::lock_guard guard{lock};
+          ready.push_back(std::move(queries));
+          changed.notify_all();
+        }
+      } catch(...) {
+        std::lock_guard guard{lock};
+        error = std::current_exception();
+      }
+
+      std::lock_guard guard{lock};
+      finished = true;
+      changed.notify_all();
+    }
+
+    //
+    // Bounds must be taken in order, and errors raised while encoding them 
+    // are raised again here.
+    //
+    std::vector<qdimacs> pipeline::take(size_t n) {
+      std::unique_lock guard{lock};
+      black_assert(n == next);
+      changed.wait(guard, [&]() { return !ready.empty() || finished; });
+      if(ready.empty()) {
+        black_assert(error);
+        std::rethrow_exception(error);
+      }
+
+      std::vector<qdimacs> queries = std::move(ready.front());
+      ready.pop_front();
+      next++;
+      changed.notify_all();
+
+      return queries;
+    }
+
+    struct bound_search {
+      bound_search(spec sp, qbf_options const& opts);
+
+      bool launch(std::deque<attempt> &window, size_t n);
+      void wait(std::deque<attempt> &window);
+
+      black::tribool linear();
+      black::tribool gallop();
+
+      encoder enc;
+      qbf_options const& opts;
+      std::optional<cache> results;
+      std::optional<expansion> expanded;
+      std::optional<cegar> refined;
+      std::array<std::optional<stepwise>, 2> sessions;
+      std::optional<std::chrono::steady_clock::time_point> deadline;
+      preprocess_stats stats;
+
+      // the bounds encoded in the background, in the linear search
+      std::optional<pipeline> ahead;
+
+      // the bound at which some player is guaranteed to win, if known, and
+      // never below the first bound tried
+      std::optional<size_t> threshold;
+
+      // the first bound tried, never below 3
+      size_t start = 3;
+    };
+
+    bound_search::bound_search(spec sp, qbf_options const& o) 
+      : enc{encode(sp), sp.type, o.clausifier, o.lasso}, opts{o}
+    {
+      if(opts.timeout)
+        deadline = std::chrono::steady_clock::now() + *opts.timeout;
       
-      qbformula formulaE = 
-        encoder{sigma, aut}.encode(player_t::environment, sp.type, n);
+      if(opts.cache_dir)
+        results.emplace(*opts.cache_dir);
+
+      if(opts.expand > 0 && sat_solver::is_available())
+        expanded.emplace(
+          enc.aut, sp.type, opts.lasso, *sp.formula.sigma()
+        );
+
+      if(opts.cegar)
+        refined.emplace(enc.aut, sp.type, opts.lasso, *sp.formula.sigma());
+
+      if(opts.incremental)
+        for(size_t p = 0; p < players.size(); p++)
+          sessions[p].emplace(enc, players[p], opts.backend);
 
-      qdimacs qdE = clausify(formulaE);
+      threshold = completeness_threshold(enc.aut, opts.lasso, opts.threshold);
+      if(threshold) {
+        threshold = std::max(*threshold, size_t{3});
+        std::cerr << "Completeness threshold: n = " << *threshold << "\n";
+      }
+
+      start = std::max(opts.start.value_or(starting_bound(sp)), size_t{3});
+      if(threshold)
+        start = std::min(start, *threshold);
+      std::cerr << "Starting bound: n = " << start 
+                << " (skipping " << start - 3 << " bounds)\n";
+
+      if(debug)
+        std::cerr << enc.aut << "\n";
+    }
 
-      if(debug) {
-        std::cerr << "- n = " << n << "\n";
-        std::cerr << "formula: " << to_string(formulaE) << "\n";
+    //
+    // Launches the queries of bound n at the end of the window, unless the 
+    // time is over.
+    //
+    bool bound_search::launch(std::deque<attempt> &window, size_t n) {
+      limits_t limits = opts.limits;
+      if(deadline) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+          *deadline - std::chrono::steady_clock::now()
+        );
+        if(left.count() <= 0)
+          return false;
+        limits.timeout = 
+          limits.timeout ? std::min(*limits.timeout, left) : left;
       }
 
-      if(is_sat(qdC) == true)
+      attempt &a = window.emplace_back();
+      a.n = n;
+
+      if(expanded && enc.aut.inputs.size() * n < opts.expand) {
+        std::array<black::tribool, 2> answers = expanded->solve(n);
+        for(size_t p = 0; p < players.size(); p++)
+          a.queries[p].emplace(answers[p]);
         return true;
+      }
+
+      if(refined) {
+        std::array<black::tribool, 2> answers = refined->solve(n);
+        for(size_t p = 0; p < players.size(); p++)
+          a.queries[p].emplace(answers[p]);
+        return true;
+      }
+
+      // the sessions can only move forward, which bisection does not. They
+      // are solved right here, so the environment's query is not even posed
+      // when the controller wins, since the controller would prevail anyway.
+      if(sessions[0] && n >= sessions[0]->steps) {
+        black::tribool won = sessions[0]->solve(n);
+        a.queries[0].emplace(won);
+        if(!(won == true))
+          a.queries[1].emplace(sessions[1]->solve(n));
+        return true;
+      }
+
+      if(opts.search == search_t::linear && opts.lookahead > 0 && !ahead)
+        ahead.emplace(enc, opts, stats, n, threshold);
+
+      std::vector<qdimacs> queries;
+      if(ahead)
+        queries = ahead->take(n);
+      else {
+        unrolling u = enc.unravel(n);
+        for(player_t p : players) {
+          qdimacs qd = enc.encode(p, n, u);
+          if(opts.preprocess)
+            qd = preprocess(qd, stats);
+          queries.push_back(std::move(qd));
+        }
+      }
+
+      for(size_t p = 0; p < players.size(); p++) {
+        qdimacs const& qd = queries[p];
+        if(debug) {
+          std::cerr << "- n = " << n << "\n";
+          std::cerr << "QDIMACS: \n" << to_string(qd) << "\n";
+        }
+
+        a.queries[p].emplace(
+          qd, opts.backend, limits, results ? &*results : nullptr
+        );
+      }
+
+      // queries answered by the cache or solved in a forked child are not
+      // sent anywhere
+      size_t controller = a.queries[0]->size();
+      size_t environment = a.queries[1]->size();
+      if(controller + environment > 0)
+        std::cerr << "Bound n = " << n << ": sent " << controller << " and "
+                  << environment << " bytes of QDIMACS\n";
+
+      return true;
+    }
+
+    //
+    // All the queries in the window run concurrently. This waits for one of 
+    // them to answer. If the answer is a win, queries at larger bounds are 
+    // not needed anymore and are all stopped together.
+    //
+    void bound_search::wait(std::deque<attempt> &window) {
+      std::vector<query *> running;
+      std::vector<std::pair<size_t, size_t>> owners;
+      for(size_t i = 0; i < window.size(); i++) {
+        for(size_t p = 0; p < players.size(); p++) {
+          if(window[i].queries[p]) {
+            running.push_back(&*window[i].queries[p]);
+            owners.push_back({i, p});
+          }
+        }
+      }
+
+      auto [i, p] = owners[query::wait_any(running)];
+      attempt &a = window[i];
+      black::tribool result = a.queries[p]->result();
+      a.queries[p].reset();
+      a.answered++;
+
+      if(result == true) {
+        // the environment's query is useless after a controller's win
+        a.winner = players[p];
+        if(players[p] == player_t::controller)
+          a.queries[1].reset();
+
+        // larger bounds are not needed anymore, and their backends are all
+        // stopped together rather than one by one
+        std::vector<query *> dropped;
+        for(size_t j = i + 1; j < window.size(); j++)
+          for(auto &q : window[j].queries)
+            dropped.push_back(q ? &*q : nullptr);
+        query::cancel_all(dropped);
+        window.erase(window.begin() + std::ptrdiff_t(i) + 1, window.end());
+      } else if(result == false)
+        a.refuted++;
+    }
+
+    //
+    // Bounds n, n + 1, ... are attempted in a sliding window. A win at some 
+    // bound is sound, but it is reported only when all the smaller bounds are
+    // settled, so that the answer comes from the smallest decisive bound, as
+    // if bounds were tried one by one.
+    //
+    black::tribool bound_search::linear() {
+      std::deque<attempt> window;
+      size_t next = start;
+
+      // the largest bound up to which neither player could win
+      std::optional<size_t> decided;
+
+      // whether no more bounds have to be attempted, either because one of 
+      // them was decisive or because some query ran out of resources
+      bool stop = false;
+
+      auto fill = [&]() {
+        while(!stop && window.size() < std::max(opts.window, size_t{1})) {
+          if(threshold && next > *threshold)
+            stop = true;
+          else if(!launch(window, next++))
+            stop = true;
+        }
+
+        // no more bounds are launched, so none has to be encoded ahead
+        if(stop)
+          ahead.reset();
+      };
+
+      while(true) {
+        fill();
+
+        // settle the smallest bounds in order
+        while(!window.empty() && window.front().settled()) {
+          attempt &a = window.front();
+          if(a.winner) {
+            std::cerr << "Decisive bound: n = " << a.n << "\n";
+            return *a.winner == player_t::controller;
+          }
+          
+          // a query that ran out of resources at this bound would likely do
+          // so at any larger bound as well
+          if(a.refuted < a.queries.size())
+            stop = true;
+          else if(!stop)
+            decided = a.n;
+          
+          window.pop_front();
+          fill();
+        }
+
+        if(window.empty())
+          return unknown(decided);
+
+        wait(window);
+        if(window.back().winner)
+          stop = true;
+      }
+    }
+
+    //
+    // The bound is doubled until some player wins. Assuming that winning is 
+    // monotone in the bound, as it is for the controller's reachability
+    // objective, the smallest winning bound is then found by bisection, if 
+    // requested. Without monotonicity the answer is still sound, but the
+    // reported bound might not be the smallest one.
+    //
+    black::tribool bound_search::gallop() {
+      // the largest bound known to have no winner, and the smallest one known
+      // to have one
+      std::optional<size_t> decided;
+      std::optional<size_t> decisive;
+      std::optional<player_t> winner;
       
-      if(is_sat(qdE) == true)
-        return false;
-      
-      n++;
-    }    
+      auto probe = [&](size_t n) {
+        std::deque<attempt> window;
+        if(!launch(window, n)) {
+          std::cerr << "Bound n = " << n << ": out of time\n";
+          return false;
+        }
+        while(!window.front().settled())
+          wait(window);
+        
+        attempt &a = window.front();
+        if(a.winner) {
+          std::cerr << "Bound n = " << n << ": " << 
+            (*a.winner == player_t::controller ? "controller" : "environment")
+            << " wins\n";
+          decisive = n;
+          winner = a.winner;
+          return true;
+        }
+        if(a.refuted < a.queries.size()) {
+          std::cerr << "Bound n = " << n << ": unknown\n";
+          return false;
+        }
+
+        std::cerr << "Bound n = " << n << ": no winner\n";
+        decided = n;
+        return true;
+      };
+
+      size_t last = threshold.value_or(std::numeric_limits<size_t>::max());
+      for(size_t n = start; !winner; n = std::min(n * 2, last)) {
+        if(!probe(n) || (!winner && n == last))
+          return unknown(decided);
+      }
+
+      if(opts.minimal) {
+        // bounds below the starting one are never probed, as in the first
+        // phase
+        size_t lo = decided.value_or(start - 1);
+        while(*decisive - lo > 1) {
+          size_t mid = lo + (*decisive - lo) / 2;
+          if(!probe(mid))
+            break;
+          if(decided == mid)
+            lo = mid;
+        }
+      }
+
+      std::cerr << "Decisive bound: n = " << *decisive << "\n";
+
+      return *winner == player_t::controller;
+    }
+  }
+
+  std::string to_string(search_t strategy) {
+    switch(strategy) {
+      case search_t::linear:
+        return "linear";
+      case search_t::gallop:
+        return "gallop";
+    }
+    black_unreachable();
+  }
+
+  std::optional<search_t> to_search(std::string const& name) {
+    if(name == "linear")
+      return search_t::linear;
+    if(name == "gallop")
+      return search_t::gallop;
+    return {};
+  }
+
+  std::string to_string(threshold_t threshold) {
+    switch(threshold) {
+      case threshold_t::structural:
+        return "structural";
+      case threshold_t::reachable:
+        return "reachable";
+    }
+    black_unreachable();
+  }
+
+  std::optional<threshold_t> to_threshold(std::string const& name) {
+    if(name == "structural")
+      return threshold_t::structural;
+    if(name == "reachable")
+      return threshold_t::reachable;
+    return {};
+  }
+
+  std::string to_string(encoding_t encoding) {
+    switch(encoding) {
+      case encoding_t::unrolling:
+        return "unrolling";
+      case encoding_t::positional:
+        return "positional";
+    }
+    black_unreachable();
+  }
+
+  std::optional<encoding_t> to_encoding(std::string const& name) {
+    if(name == "unrolling")
+      return encoding_t::unrolling;
+    if(name == "positional")
+      return encoding_t::positional;
+    return {};
+  }
+
+  std::string to_string(lasso_t lasso) {
+    switch(lasso) {
+      case lasso_t::pairwise:
+        return "pairwise";
+      case lasso_t::compact:
+        return "compact";
+    }
+    black_unreachable();
+  }
+
+  std::optional<lasso_t> to_lasso(std::string const& name) {
+    if(name == "pairwise")
+      return lasso_t::pairwise;
+    if(name == "compact")
+      return lasso_t::compact;
+    return {};
+  }
+
+  black::tribool is_realizable_qbf(spec sp, qbf_options const& opts) {
+    if(opts.encoding == encoding_t::positional)
+      return is_realizable_dqbf(sp, opts);
+
+    bound_search s{sp, opts};
+
+    black::tribool result = black::tribool::undef;
+    switch(opts.search) {
+      case search_t::linear:
+        result = s.linear();
+        break;
+      case search_t::gallop:
+        result = s.gallop();
+        break;
+    }
+
+    if(opts.preprocess)
+      std::cerr << s.stats;
+
+    return result;
   }
 
 }
@@ -0,0 +1,232 @@
+//
+// Synthetico - Pure-past LTL synthesizer based on BLACK
+//
+// (C) 2023 Nicola Gigante
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#include "synthetico/synthetico.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace synth {
+
+  // 2^bits, if it fits
+  static std::optional<size_t> power(size_t bits) {
+    if(bits >= std::numeric_limits<size_t>::digits)
+      return {};
+    return size_t{1} << bits;
+  }
+
+  //
+  // Breadth-first search from the initial state, with the image computed by
+  // conjoining the frontier with the definitions of the primed variables
+  // and abstracting the current state and the moves.
+  //
+  static std::optional<size_t> reachable_states(automata const& aut) {
+    CUDD::Cudd mgr;
+    std::unordered_map<proposition, CUDD::BDD> bdds;
+
+    int index = 0;
+    std::vector<CUDD::BDD> current, moves, next;
+    for(proposition v : aut.variables) {
+      current.push_back(mgr.bddVar(index++));
+      bdds.insert({v, current.back()});
+    }
+    for(auto const& props : {aut.inputs, aut.outputs}) {
+      for(proposition p : props) {
+        moves.push_back(mgr.bddVar(index++));
+        bdds.insert({p, moves.back()});
+      }
+    }
+    for(size_t j = 0; j < aut.variables.size(); j++)
+      next.push_back(mgr.bddVar(index++));
+
+    std::function<CUDD::BDD(bformula)> to_bdd = [&](bformula f) {
+      return f.match(
+        [&](logic::boolean b) { 
+          return b.value() ? mgr.bddOne() : mgr.bddZero(); 
+        },
+        [&](proposition p) { return bdds.at(p); },
+        [&](logic::negation<Bool>, auto arg) { return !to_bdd(arg); },
+        [&](logic::conjunction<Bool>, auto left, auto right) {
+          return to_bdd(left) & to_bdd(right);
+        },
+        [&](logic::disjunction<Bool>, auto left, auto right) {
+          return to_bdd(left) | to_bdd(right);
+        },
+        [&](logic::implication<Bool>, auto left, auto right) {
+          return !to_bdd(left) | to_bdd(right);
+        },
+        [&](logic::iff<Bool>, auto left, auto right) {
+          return to_bdd(left).Xnor(to_bdd(right));
+        }
+      );
+    };
+
+    std::vector<bformula> defs = next_state(aut);
+    CUDD::BDD trans = mgr.bddOne();
+    for(size_t j = 0; j < defs.size(); j++)
+      trans &= next[j].Xnor(to_bdd(defs[j]));
+
+    std::vector<CUDD::BDD> abstracted = current;
+    abstracted.insert(abstracted.end(), moves.begin(), moves.end());
+    CUDD::BDD cube = mgr.computeCube(abstracted);
+
+    std::vector<bool> init = initial_state(aut);
+    CUDD::BDD reached = mgr.bddOne();
+    for(size_t j = 0; j < init.size(); j++)
+      reached &= init[j] ? current[j] : !current[j];
+
+    CUDD::BDD frontier = reached;
+    while(!frontier.IsZero()) {
+      CUDD::BDD image = 
+        frontier.AndAbstract(trans, cube).SwapVariables(next, current);
+      frontier = image & !reached;
+      reached |= image;
+    }
+
+    double count = reached.CountMinterm(int(current.size()));
+    if(count >= std::ldexp(1.0, std::numeric_limits<size_t>::digits - 1))
+      return {};
+    return size_t(count);
+  }
+
+  std::optional<size_t> 
+  completeness_threshold(automata const& aut, lasso_t lasso, threshold_t kind)
+  {
+    std::optional<size_t> states = kind == threshold_t::reachable ? 
+      reachable_states(aut) : power(aut.variables.size());
+    if(!states)
+      return {};
+
+    size_t reach = *states - 1;
+    if(lasso == lasso_t::compact)
+      return std::max(reach, *states);
+
+    std::optional<size_t> moves = 
+      power(aut.inputs.size() + aut.outputs.size());
+    if(!moves || *moves == std::numeric_limits<size_t>::max())
+      return {};
+    
+    return std::max(reach, *moves + 1);
+  }
+
+  // the earliest step at which a formula can hold, if it can at all
+  using delay_t = std::optional<size_t>;
+
+  static delay_t earlier(delay_t a, delay_t b) {
+    if(!a || !b)
+      return a ? a : b;
+    return std::min(*a, *b);
+  }
+
+  static delay_t later(delay_t a, delay_t b) {
+    if(!a || !b)
+      return {};
+    return std::max(*a, *b);
+  }
+
+  static delay_t after(delay_t a) {
+    if(!a)
+      return {};
+    return *a + 1;
+  }
+
+  //
+  // A lower bound to the earliest step at which f (or its negation, if not 
+  // positive) holds in any trace. Only `Y`, and `Z` under negation, delay 
+  // their argument, while the other past operators hold only if their 
+  // right argument holds at the same step or earlier.
+  //
+  static delay_t delay(formula<pLTL> f, bool positive) {
+    return f.match(
+      [&](logic::boolean b) -> delay_t {
+        if(b.value() == positive)
+          return 0;
+        return {};
+      },
+      [](proposition) -> delay_t { return 0; },
+      [&](logic::negation<pLTL>, auto arg) {
+        return delay(arg, !positive);
+      },
+      [&](logic::conjunction<pLTL>, auto left, auto right) {
+        delay_t l = delay(left, positive), r = delay(right, positive);
+        return positive ? later(l, r) : earlier(l, r);
+      },
+      [&](logic::disjunction<pLTL>, auto left, auto right) {
+        delay_t l = delay(left, positive), r = delay(right, positive);
+        return positive ? earlier(l, r) : later(l, r);
+      },
+      [&](logic::implication<pLTL>, auto left, auto right) {
+        delay_t l = delay(left, !positive), r = delay(right, positive);
+        return positive ? earlier(l, r) : later(l, r);
+      },
+      [&](logic::iff<pLTL>, auto left, auto right) {
+        delay_t lt = delay(left, true), lf = delay(left, false);
+        delay_t rt = delay(right, true), rf = delay(right, false);
+        if(positive)
+          return earlier(later(lt, rt), later(lf, rf));
+        return earlier(later(lt, rf), later(lf, rt));
+      },
+      [&](logic::yesterday<pLTL>, auto arg) -> delay_t {
+        if(positive)
+          return after(delay(arg, true));
+        return 0;
+      },
+      [&](logic::w_yesterday<pLTL>, auto arg) -> delay_t {
+        if(positive)
+          return 0;
+        return after(delay(arg, false));
+      },
+      [&](logic::once<pLTL>, auto arg) { return delay(arg, positive); },
+      [&](logic::historically<pLTL>, auto arg) { 
+        return delay(arg, positive); 
+      },
+      [&](logic::since<pLTL>, auto, auto right) { 
+        return delay(right, positive); 
+      },
+      [&](logic::triggered<pLTL>, auto, auto right) { 
+        return delay(right, positive); 
+      }
+    );
+  }
+
+  //
+  // The objective of the automaton is the target one step later, so the
+  // reachability player needs a bound at least one past the target's delay.
+  //
+  size_t starting_bound(spec sp) {
+    delay_t target = sp.type.match(
+      [&](game_t::eventually) { return delay(sp.formula, true); },
+      [&](game_t::always) { return delay(sp.formula, false); }
+    );
+
+    return std::max(after(target).value_or(0), size_t{3});
+  }
+
+}
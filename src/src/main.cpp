@@ -26,13 +26,17 @@
 
 #include "synthetico/synthetico.hpp"
 
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 enum class algorithm {
   qbf,
-  bdd
+  bdd,
+  portfolio
 };
 
 static char *argv0 = nullptr;
@@ -41,10 +45,29 @@ static char *argv0 = nullptr;
 static void error(std::string err) {
   std::cerr << argv0 << ": error: " + err + "\n";
   std::cerr << argv0 << ": usage: " << argv0;
-  std::cerr << " (qbf|bdd) <formula> [input 1] [input 2] ..."
+  std::cerr << " (qbf|bdd|portfolio) [options] <formula> [input 1] ..."
                 " [input n]\n";
   std::cerr << argv0 << ": usage: " << argv0;
   std::cerr << " random <n formulas> <n vars> <size> <seed>\n";
+  std::cerr << argv0 << ": options:\n"
+    "  --backend=(pedant|dqbdd|depqbf)    QBF solver to use\n"
+    "  --timeout=<seconds>                budget for the whole search\n"
+    "  --query-timeout=<seconds>          budget for each QBF query\n"
+    "  --memory-limit=<megabytes>         memory for each QBF query\n"
+    "  --cache-dir=<path>                 cache of QBF query results\n"
+    "  --window=<bounds>                  bounds to solve concurrently\n"
+    "  --lookahead=<bounds>               bounds to encode in advance\n"
+    "  --search=(linear|gallop)           how to increase the bound\n"
+    "  --minimal                          bisect to the smallest bound\n"
+    "  --threshold=(structural|reachable) where the search stops\n"
+    "  --start=<bound>                    first bound to try\n"
+    "  --cnf=(tseitin|polarity)           how to clausify the queries\n"
+    "  --encoding=(unrolling|positional)  what the queries state\n"
+    "  --lasso=(pairwise|compact)         lasso encoding for safety\n"
+    "  --expand=<threshold>               expand small bounds to SAT\n"
+    "  --cegar                            solve by abstraction refinement\n"
+    "  --preprocess                       simplify the queries\n"
+    "  --incremental                      keep depqbf alive across bounds\n";
 
   exit(1);
 }
@@ -56,6 +79,8 @@ static algorithm to_algo(std::string algos) {
     return algorithm::qbf;
   else if(algos == "bdd"s)
       return algorithm::bdd;
+  else if(algos == "portfolio"s)
+    return algorithm::portfolio;
   else
     error("unknown algorithm");
 }
@@ -66,11 +91,15 @@ static std::string to_string(algorithm algo) {
       return "qbf";
     case algorithm::bdd:
       return "bdd";
+    case algorithm::portfolio:
+      return "portfolio";
   }
   black_unreachable();
 }
 
-static int solve(synth::spec spec, algorithm algo) {
+static int solve(
+  synth::spec spec, algorithm algo, synth::qbf_options const& opts
+) {
   black::tribool result = black::tribool::undef;
 
   try {
@@ -78,11 +107,18 @@ static int solve(synth::spec spec, algorithm algo) {
               << "with the '" << to_string(algo) << "' algorithm...\n";
     switch(algo){ 
       case algorithm::qbf:
-        result = is_realizable_qbf(spec);
+        result = is_realizable_qbf(spec, opts);
         break;
       case algorithm::bdd:
         result = is_realizable_bdd(spec);
         break;
+      case algorithm::portfolio: {
+        synth::portfolio_result res = is_realizable_portfolio(spec, opts);
+        result = res.realizable;
+        if(!res.engine.empty())
+          std::cerr << "The '" << res.engine << "' algorithm answered first\n";
+        break;
+      }
     }
   } catch(std::exception const& ex) {
     std::cerr << argv0 << ": uncaught exception: " << ex.what() << "\n";
@@ -152,17 +188,155 @@ static int random(int argc, char **argv){
   return 0;
 }
 
+static std::chrono::milliseconds to_duration(std::string seconds) {
+  auto secs = from_string<double>(seconds);
+  if(!secs || *secs <= 0)
+    error("invalid amount of seconds '" + seconds + "'");
+
+  return std::chrono::milliseconds{int64_t(*secs * 1000)};
+}
+
+//
+// Options take the form `--name=value` (or just `--name` for flags) and can
+// appear anywhere after the algorithm. They are removed from the arguments,
+// leaving the positional ones.
+//
+static std::vector<char *> 
+parse_options(int argc, char **argv, synth::qbf_options &opts) {
+  using namespace std::literals;
+  
+  std::vector<char *> args;
+  for(int i = 0; i < argc; i++) {
+    std::string arg = argv[i];
+    if(!arg.starts_with("--")) {
+      args.push_back(argv[i]);
+      continue;
+    }
+
+    size_t eq = arg.find('=');
+    std::string name = arg.substr(2, eq == std::string::npos ? eq : eq - 2);
+    std::string value = eq == std::string::npos ? ""s : arg.substr(eq + 1);
+
+    if(name == "backend") {
+      auto backend = synth::to_backend(value);
+      if(!backend)
+        error("unknown backend '" + value + "'");
+      if(!synth::is_available(*backend))
+        error("backend '" + value + "' is not available in this build");
+      opts.backend = *backend;
+    } else if(name == "timeout") {
+      opts.timeout = to_duration(value);
+    } else if(name == "query-timeout") {
+      opts.limits.timeout = to_duration(value);
+    } else if(name == "memory-limit") {
+      auto mb = from_string<size_t>(value);
+      if(!mb || *mb == 0)
+        error("invalid memory limit '" + value + "'");
+      opts.limits.memory = *mb * 1024 * 1024;
+    } else if(name == "cache-dir") {
+      if(value.empty())
+        error("invalid cache directory");
+      opts.cache_dir = value;
+    } else if(name == "window") {
+      auto bounds = from_string<size_t>(value);
+      if(!bounds || *bounds == 0)
+        error("invalid window size '" + value + "'");
+      opts.window = *bounds;
+    } else if(name == "lookahead") {
+      auto bounds = from_string<size_t>(value);
+      if(!bounds)
+        error("invalid number of bounds '" + value + "'");
+      opts.lookahead = *bounds;
+    } else if(name == "search") {
+      auto search = synth::to_search(value);
+      if(!search)
+        error("unknown search strategy '" + value + "'");
+      opts.search = *search;
+    } else if(name == "threshold") {
+      auto threshold = synth::to_threshold(value);
+      if(!threshold)
+        error("unknown completeness threshold '" + value + "'");
+      opts.threshold = *threshold;
+    } else if(name == "start") {
+      auto bound = from_string<size_t>(value);
+      if(!bound || *bound < 3)
+        error("invalid starting bound '" + value + "'");
+      opts.start = *bound;
+    } else if(name == "minimal") {
+      if(eq != std::string::npos)
+        error("option '--minimal' does not take a value");
+      opts.minimal = true;
+    } else if(name == "cnf") {
+      auto clausifier = synth::to_clausifier(value);
+      if(!clausifier)
+        error("unknown clausifier '" + value + "'");
+      opts.clausifier = *clausifier;
+    } else if(name == "encoding") {
+      auto encoding = synth::to_encoding(value);
+      if(!encoding)
+        error("unknown encoding '" + value + "'");
+      opts.encoding = *encoding;
+    } else if(name == "lasso") {
+      auto lasso = synth::to_lasso(value);
+      if(!lasso)
+        error("unknown lasso encoding '" + value + "'");
+      opts.lasso = *lasso;
+    } else if(name == "expand") {
+      auto threshold = from_string<size_t>(value);
+      if(!threshold)
+        error("invalid expansion threshold '" + value + "'");
+      opts.expand = *threshold;
+    } else if(name == "cegar") {
+      if(eq != std::string::npos)
+        error("option '--cegar' does not take a value");
+      if(!synth::sat_solver::is_available())
+        error("option '--cegar' needs a SAT backend in BLACK");
+      opts.cegar = true;
+    } else if(name == "preprocess") {
+      if(eq != std::string::npos)
+        error("option '--preprocess' does not take a value");
+      opts.preprocess = true;
+    } else if(name == "incremental") {
+      if(eq != std::string::npos)
+        error("option '--incremental' does not take a value");
+      opts.incremental = true;
+    } else
+      error("unknown option '--" + name + "'");
+  }
+
+  return args;
+}
+
 static int formula(int argc, char **argv) {
-  if(argc < 3)
+  synth::qbf_options opts;
+  if(char const *dir = getenv("SYNTH_CACHE_DIR"); dir && *dir)
+    opts.cache_dir = dir;
+  std::vector<char *> args = parse_options(argc, argv, opts);
+
+  if(opts.incremental && !synth::incremental_solver::is_supported(opts.backend))
+    error("option '--incremental' needs the 'depqbf' backend");
+
+  // incremental sessions are solved synchronously, out of any time limit
+  if(opts.incremental && (
+    opts.timeout || opts.limits.timeout || opts.limits.memory || 
+    opts.window > 1
+  ))
+    error(
+      "option '--incremental' does not support '--timeout', "
+      "'--query-timeout', '--memory-limit' and '--window'"
+    );
+
+  if(args.size() < 3)
     error("insufficient command-line arguments");
 
-  algorithm algo = to_algo(argv[1]);
+  algorithm algo = to_algo(args[1]);
 
   black::alphabet sigma;
 
-  synth::spec spec = *synth::parse(sigma, argc - 1, argv + 1, error);
+  synth::spec spec = 
+    *synth::parse(sigma, int(args.size()) - 1, args.data() + 1, error);
 
-  return solve(spec, algo);
+  return solve(spec, algo, opts);
 }
 
 int main(int argc, char **argv) {
@@ -0,0 +1,462 @@
+//
+// Synthetico - Pure-past LTL synthesizer based on BLACK
+//
+// (C) 2023 Nicola Gigante
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#include "synthetico/synthetico.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <ostream>
+#include <stop_token>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace synth {
+
+  std::ostream &operator<<(std::ostream &str, preprocess_stats const& s) {
+    str << "Preprocessed " << s.queries << " queries: " 
+        << s.clauses_before << " -> " << s.clauses_after << " clauses\n";
+    str << "- universal reduction: " << s.universal_reduction << " literals\n";
+    str << "- unit propagation: " << s.units << " variables\n";
+    str << "- pure literals: " << s.pure_literals << " variables\n";
+    str << "- equivalent literals: " << s.equivalences << " variables\n";
+    str << "- blocked clauses: " << s.blocked_clauses << " clauses\n";
+
+    return str;
+  }
+
+  namespace {
+    var_t var(lit_t lit) { return var_t(std::abs(lit)); }
+
+    size_t index(lit_t lit) { return 2 * size_t(var(lit)) + (lit < 0); }
+
+    //
+    // Quantifier levels start from 0, the level of free variables, which are
+    // existential, and increase whenever the quantifier changes along the
+    // prefix. Each round first applies the substitutions and assignments 
+    // found so far to all the clauses, and then rebuilds the occurrence lists,
+    // which may keep clauses that have lost the literal in the meantime.
+    //
+    struct preprocessor {
+      preprocessor(qdimacs const& qd, preprocess_stats &stats);
+
+      qdimacs run(std::stop_token stop);
+
+      lit_t find(lit_t lit);
+      void simplify(size_t i);
+      void assign(lit_t lit);
+      bool occurs(lit_t lit) const;
+      void build_occurrences();
+      bool propagate();
+      bool pure_literals();
+      bool merge(lit_t x, lit_t y);
+      bool equivalences();
+      bool blocked_clauses();
+      qdimacs result() const;
+
+      qdimacs const& qd;
+      preprocess_stats &stats;
+
+      // indexed by variable
+      std::vector<size_t> level;
+      std::vector<bool> universal;
+      std::vector<int8_t> value;
+      std::vector<lit_t> parent; // the literal the variable is equivalent to
+
+      std::vector<std::vector<lit_t>> clauses;
+      std::vector<bool> removed;
+      std::vector<std::vector<size_t>> occurrences; // indexed by literal
+      std::vector<lit_t> units;
+      bool unsat = false;
+
+      // literals visited by blocked clause elimination before giving up
+      size_t budget = size_t{1} << 24;
+    };
+
+    preprocessor::preprocessor(qdimacs const& q, preprocess_stats &s)
+      : qd{q}, stats{s}, 
+        level(qd.n_vars + 1, 0), universal(qd.n_vars + 1, false),
+        value(qd.n_vars + 1, 0), parent(qd.n_vars + 1, 0)
+    {
+      size_t current = 0;
+      auto type = qdimacs_block::existential;
+      for(auto const& block : qd.blocks) {
+        if(block.variables.empty())
+          continue;
+        if(block.type != type) {
+          current++;
+          type = block.type;
+        }
+        for(var_t v : block.variables) {
+          level[v] = current;
+          universal[v] = block.type == qdimacs_block::universal;
+        }
+      }
+
+      clauses.reserve(qd.clauses.size());
+      for(clause cl : qd.clauses)
+        clauses.emplace_back(cl.begin(), cl.end());
+      removed.resize(clauses.size(), false);
+    }
+
+    lit_t preprocessor::find(lit_t lit) {
+      auto up = [&](lit_t l) {
+        lit_t p = parent[var(l)];
+        return l > 0 ? p : -p;
+      };
+
+      lit_t root = lit;
+      while(parent[var(root)] != 0)
+        root = up(root);
+
+      while(parent[var(lit)] != 0) {
+        lit_t next = up(lit);
+        parent[var(lit)] = lit > 0 ? root : -root;
+        lit = next;
+      }
+
+      return root;
+    }
+
+    //
+    // Applies assignments and substitutions to the clause, removes it if 
+    // satisfied or tautological, and applies universal reduction.
+    //
+    void preprocessor::simplify(size_t i) {
+      std::vector<lit_t> result;
+      result.reserve(clauses[i].size());
+      for(lit_t lit : clauses[i]) {
+        lit = find(lit);
+        if(int8_t val = value[var(lit)]; val != 0) {
+          if((val > 0) == (lit > 0)) {
+            removed[i] = true;
+            return;
+          }
+          continue;
+        }
+        result.push_back(lit);
+      }
+
+      std::sort(result.begin(), result.end(), [](lit_t a, lit_t b) {
+        return var(a) < var(b) || (var(a) == var(b) && a < b);
+      });
+      result.erase(std::unique(result.begin(), result.end()), result.end());
+      for(size_t j = 1; j < result.size(); j++) {
+        if(var(result[j]) == var(result[j - 1])) {
+          removed[i] = true;
+          return;
+        }
+      }
+
+      // universal literals quantified after all the existential ones
+      bool existential = false;
+      size_t inner = 0;
+      for(lit_t lit : result) {
+        if(!universal[var(lit)]) {
+          existential = true;
+          inner = std::max(inner, level[var(lit)]);
+        }
+      }
+      size_t before = result.size();
+      std::erase_if(result, [&](lit_t lit) {
+        return universal[var(lit)] && (!existential || level[var(lit)] > inner);
+      });
+      stats.universal_reduction += before - result.size();
+
+      if(result.empty())
+        unsat = true;
+      else if(result.size() == 1)
+        units.push_back(result[0]);
+
+      clauses[i] = std::move(result);
+    }
+
+    void preprocessor::assign(lit_t lit) {
+      value[var(lit)] = lit > 0 ? 1 : -1;
+      
+      for(lit_t l : {lit, -lit})
+        for(size_t i : occurrences[index(l)])
+          if(!removed[i])
+            simplify(i);
+    }
+
+    bool preprocessor::occurs(lit_t lit) const {
+      for(size_t i : occurrences[index(lit)])
+        if(!removed[i])
+          return true;
+      return false;
+    }
+
+    void preprocessor::build_occurrences() {
+      occurrences.assign(2 * (qd.n_vars + 1), {});
+      for(size_t i = 0; i < clauses.size(); i++)
+        if(!removed[i])
+          for(lit_t lit : clauses[i])
+            occurrences[index(lit)].push_back(i);
+    }
+
+    //
+    // Unit clauses are always existential, since universal reduction empties
+    // clauses made of universal literals only.
+    //
+    bool preprocessor::propagate() {
+      bool changed = false;
+      while(!units.empty() && !unsat) {
+        lit_t lit = find(units.back());
+        units.pop_back();
+
+        if(int8_t val = value[var(lit)]; val != 0) {
+          if((val > 0) != (lit > 0))
+            unsat = true;
+          continue;
+        }
+
+        stats.units++;
+        changed = true;
+        assign(lit);
+      }
+
+      return changed;
+    }
+
+    //
+    // Existential pure literals are satisfied, universal ones are falsified.
+    //
+    bool preprocessor::pure_literals() {
+      bool changed = false;
+      for(var_t v = 1; v <= qd.n_vars && !unsat; v++) {
+        if(value[v] != 0 || parent[v] != 0)
+          continue;
+
+        bool pos = occurs(lit_t(v));
+        bool neg = occurs(-lit_t(v));
+        if(pos == neg)
+          continue;
+
+        lit_t lit = pos ? lit_t(v) : -lit_t(v);
+        stats.pure_literals++;
+        changed = true;
+        assign(universal[v] ? -lit : lit);
+      }
+
+      return changed;
+    }
+
+    //
+    // Records that x and y are equivalent. The root of each class is its 
+    // outermost variable, which may be universal only if all the others are 
+    // existential and quantified after it, so that they can depend on it.
+    //
+    bool preprocessor::merge(lit_t x, lit_t y) {
+      lit_t rx = find(x);
+      lit_t ry = find(y);
+      if(var(rx) == var(ry)) {
+        if(rx != ry)
+          unsat = true;
+        return false;
+      }
+
+      var_t vx = var(rx);
+      var_t vy = var(ry);
+      if(universal[vx] && universal[vy])
+        return false;
+
+      bool x_root = universal[vx] || (!universal[vy] && 
+        std::pair{level[vx], vx} < std::pair{level[vy], vy});
+      
+      lit_t root = x_root ? rx : ry;
+      lit_t child = x_root ? ry : rx;
+      if(universal[var(root)] && level[var(root)] > level[var(child)])
+        return false;
+
+      parent[var(child)] = child > 0 ? root : -root;
+      stats.equivalences++;
+      
+      return true;
+    }
+
+    // the binary clauses {a, b} and {-a, -b} make a and -b equivalent
+    bool preprocessor::equivalences() {
+      auto key = [](lit_t a, lit_t b) {
+        if(a > b)
+          std::swap(a, b);
+        return (uint64_t(uint32_t(a)) << 32) | uint32_t(b);
+      };
+
+      std::unordered_set<uint64_t> binary;
+      for(size_t i = 0; i < clauses.size(); i++)
+        if(!removed[i] && clauses[i].size() == 2)
+          binary.insert(key(clauses[i][0], clauses[i][1]));
+
+      bool changed = false;
+      for(size_t i = 0; i < clauses.size() && !unsat; i++) {
+        if(removed[i] || clauses[i].size() != 2)
+          continue;
+        
+        lit_t a = clauses[i][0];
+        lit_t b = clauses[i][1];
+        if(binary.contains(key(-a, -b)) && merge(a, -b))
+          changed = true;
+      }
+
+      return changed;
+    }
+
+    //
+    // A clause C is blocked on an existential literal l if each resolvent of
+    // C on l contains a complementary pair of literals quantified no later
+    // than l, and can then be removed.
+    //
+    bool preprocessor::blocked_clauses() {
+      std::vector<bool> mark(2 * (qd.n_vars + 1), false);
+      
+      bool changed = false;
+      for(size_t i = 0; i < clauses.size() && budget > 0; i++) {
+        if(removed[i])
+          continue;
+
+        for(lit_t l : clauses[i]) {
+          if(universal[var(l)])
+            continue;
+
+          for(lit_t k : clauses[i])
+            if(k != l && level[var(k)] <= level[var(l)])
+              mark[index(k)] = true;
+
+          bool blocked = true;
+          for(size_t j : occurrences[index(-l)]) {
+            if(removed[j])
+              continue;
+            
+            budget -= std::min(budget, clauses[j].size());
+            bool tautology = std::any_of(
+              clauses[j].begin(), clauses[j].end(), 
+              [&](lit_t d) { return mark[index(-d)]; }
+            );
+            if(!tautology || budget == 0) {
+              blocked = false;
+              break;
+            }
+          }
+
+          for(lit_t k : clauses[i])
+            mark[index(k)] = false;
+
+          if(blocked) {
+            removed[i] = true;
+            stats.blocked_clauses++;
+            changed = true;
+            break;
+          }
+        }
+      }
+
+      return changed;
+    }
+
+    qdimacs preprocessor::run(std::stop_token stop) {
+      stats.queries++;
+      stats.clauses_before += clauses.size();
+
+      for(size_t i = 0; i < clauses.size(); i++)
+        simplify(i);
+
+      while(!unsat && !stop.stop_requested()) {
+        build_occurrences();
+
+        bool changed = propagate();
+        changed = pure_literals() || changed;
+        if(!changed)
+          changed = equivalences();
+        if(!changed)
+          changed = blocked_clauses();
+        if(!changed || unsat)
+          break;
+
+        for(size_t i = 0; i < clauses.size() && !unsat; i++)
+          if(!removed[i])
+            simplify(i);
+      }
+
+      qdimacs r = result();
+      stats.clauses_after += r.clauses.size();
+
+      return r;
+    }
+
+    qdimacs preprocessor::result() const {
+      clause_list list;
+      std::vector<bool> used(qd.n_vars + 1, false);
+      for(size_t i = 0; i < clauses.size(); i++) {
+        if(removed[i])
+          continue;
+        
+        list.push_back(clauses[i]);
+        for(lit_t lit : clauses[i])
+          used[var(lit)] = true;
+      }
+
+      // a trivial formula with the same truth value
+      if(unsat || list.empty()) {
+        clause_list trivial;
+        std::array<lit_t, 1> unit = {1};
+        trivial.push_back(unit);
+        if(unsat) {
+          unit[0] = -1;
+          trivial.push_back(unit);
+        }
+        return qdimacs{
+          1, {qdimacs_block{qdimacs_block::existential, {1}}}, 
+          std::move(trivial), {std::nullopt, std::nullopt}, {}, {}
+        };
+      }
+
+      std::vector<qdimacs_block> blocks;
+      for(auto const& block : qd.blocks) {
+        blocks.push_back(qdimacs_block{block.type, {}});
+        for(var_t v : block.variables)
+          if(used[v])
+            blocks.back().variables.push_back(v);
+      }
+
+      return qdimacs{
+        qd.n_vars, std::move(blocks), std::move(list), qd.props, qd.vars, {}
+      };
+    }
+  }
+
+  qdimacs preprocess(
+    qdimacs const& qd, preprocess_stats &stats, std::stop_token stop
+  ) {
+    // the techniques above assume a linear prefix
+    if(!qd.dependencies.empty())
+      return qd;
+
+    return preprocessor{qd, stats}.run(stop);
+  }
+
+}
@@ -0,0 +1,389 @@
+//
+// Synthetico - Pure-past LTL synthesizer based on BLACK
+//
+// (C) 2023 Nicola Gigante
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#include "synthetico/process.hpp"
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <cerrno>
+#include <cstring>
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace synth {
+
+  using clock = std::chrono::steady_clock;
+
+  // how long a child is given to exit after SIGTERM before we send SIGKILL
+  static constexpr auto grace_period = std::chrono::milliseconds{500};
+
+  [[noreturn]]
+  static void system_error(std::string what) {
+    throw std::runtime_error(what + ": " + strerror(errno));
+  }
+
+  namespace {
+    //
+    // A file descriptor closed when going out of scope, so that none is 
+    // leaked if launching the child fails halfway.
+    //
+    class descriptor {
+    public:
+      descriptor() = default;
+      explicit descriptor(int fd) : _fd{fd} { }
+      descriptor(descriptor const&) = delete;
+      ~descriptor() { reset(); }
+
+      descriptor &operator=(descriptor const&) = delete;
+
+      int get() const { return _fd; }
+
+      // closes the descriptor and takes ownership of the given one, if any
+      void reset(int fd = -1) {
+        if(_fd != -1)
+          close(_fd);
+        _fd = fd;
+      }
+
+      // gives up ownership of the descriptor without closing it
+      int release() { return std::exchange(_fd, -1); }
+
+    private:
+      int _fd = -1;
+    };
+  }
+
+  static void 
+  open_pipe(descriptor &read_end, descriptor &write_end, std::string what) {
+    int fds[2];
+    if(pipe2(fds, O_CLOEXEC) == -1)
+      system_error(what);
+    read_end.reset(fds[0]);
+    write_end.reset(fds[1]);
+  }
+
+  // called in the child between fork() and exec(), so it has to be careful
+  static void apply_limits(limits_t limits) {
+    if(!limits.memory)
+      return;
+
+    rlimit lim = { rlim_t(*limits.memory), rlim_t(*limits.memory) };
+    setrlimit(RLIMIT_AS, &lim);
+  }
+
+  //
+  // The input is stored in an anonymous memory file if possible, which is
+  // seekable and can be filled before the child starts. Otherwise we fall back
+  // to a pipe. Programs that insist on a path can be given `/dev/stdin`, which
+  // resolves to whichever of the two we used. Nothing ever touches the disk.
+  //
+  process::process(
+    std::vector<std::string> const& argv, 
+    std::function<void(int)> const& input,
+    limits_t limits
+  ) {
+    // we handle EPIPE ourselves if the child dies before reading its input
+    signal(SIGPIPE, SIG_IGN);
+
+    // the write end of the input, if it is a pipe
+    descriptor feed;
+    descriptor in{memfd_create("synth-input", MFD_CLOEXEC)};
+    bool piped = in.get() == -1;
+    if(piped)
+      open_pipe(in, feed, "unable to create input pipe");
+    
+    if(!piped) {
+      input(in.get());
+      if(lseek(in.get(), 0, SEEK_SET) == -1)
+        system_error("unable to rewind input file");
+    }
+
+    descriptor out;
+    descriptor sink;
+    open_pipe(out, sink, "unable to create output pipe");
+
+    std::vector<char *> args;
+    for(auto const& arg : argv)
+      args.push_back(const_cast<char *>(arg.c_str()));
+    args.push_back(nullptr);
+
+    _pid = fork();
+    if(_pid == -1)
+      system_error("unable to launch '" + argv[0] + "'");
+
+    if(!_pid) { // child process
+      int null = open("/dev/null", O_WRONLY | O_CLOEXEC);
+      if(dup2(in.get(), 0) == -1 || dup2(sink.get(), 1) == -1 || 
+         null == -1 || dup2(null, 2) == -1)
+        _exit(127);
+
+      apply_limits(limits);
+      execvp(args[0], args.data());
+      _exit(127);
+    }
+
+    start_clock(limits);
+    _out = out.release();
+    sink.reset();
+    in.reset();
+    if(piped) {
+      try {
+        input(feed.get());
+      } catch(std::runtime_error const&) {
+        // the child exited early, its exit status will tell what happened
+      }
+    }
+  }
+
+  process::process(std::function<int()> body, limits_t limits) {
+    descriptor out;
+    descriptor sink;
+    open_pipe(out, sink, "unable to create output pipe");
+
+    // avoid the child flushing our own pending output a second time
+    std::cout.flush();
+    std::cerr.flush();
+
+    _pid = fork();
+    if(_pid == -1)
+      system_error("unable to launch child process");
+
+    if(!_pid) { // child process
+      setpgid(0, 0);
+      int null = open("/dev/null", O_RDONLY | O_CLOEXEC);
+      if(dup2(sink.get(), 1) == -1 || null == -1 || dup2(null, 0) == -1)
+        _exit(127);
+
+      apply_limits(limits);
+
+      int code = 1;
+      try {
+        code = body();
+      } catch(std::exception const& ex) {
+        std::cerr << "uncaught exception: " << ex.what() << "\n";
+      }
+      std::cout.flush();
+      std::cerr.flush();
+      _exit(code);
+    }
+
+    // set the group from this side as well, to avoid racing with kill()
+    setpgid(_pid, _pid);
+    _group = true;
+    start_clock(limits);
+    _out = out.release();
+  }
+
+  process::process(process &&other)
+    : _pid{std::exchange(other._pid, -1)}, 
+      _group{other._group},
+      _out{std::exchange(other._out, -1)},
+      _status{other._status}, 
+      _timed_out{other._timed_out},
+      _deadline{other._deadline},
+      _output{std::move(other._output)} { }
+
+  process &process::operator=(process &&other) {
+    if(this != &other) {
+      kill();
+      _pid = std::exchange(other._pid, -1);
+      _group = other._group;
+      _out = std::exchange(other._out, -1);
+      _status = other._status;
+      _timed_out = other._timed_out;
+      _deadline = other._deadline;
+      _output = std::move(other._output);
+    }
+    return *this;
+  }
+
+  process::~process() {
+    kill();
+  }
+
+  void process::start_clock(limits_t limits) {
+    if(limits.timeout)
+      _deadline = clock::now() + *limits.timeout;
+  }
+
+  bool process::expired() const {
+    return _deadline && clock::now() >= *_deadline;
+  }
+
+  void process::drain() {
+    char buf[4096];
+
+    ssize_t n = read(_out, buf, sizeof(buf));
+    while(n < 0 && errno == EINTR)
+      n = read(_out, buf, sizeof(buf));
+
+    if(n < 0)
+      system_error("unable to read from child process");
+    
+    if(n == 0) {
+      close(_out);
+      _out = -1;
+    } else
+      _output.append(buf, size_t(n));
+  }
+
+  void process::reap() {
+    if(_out != -1) {
+      close(_out);
+      _out = -1;
+    }
+
+    while(waitpid(_pid, &_status, 0) == -1)
+      if(errno != EINTR)
+        system_error("unable to wait for child process");
+    _pid = -1;
+  }
+
+  void process::wait() {
+    std::array<process *, 1> self = { this };
+    while(running())
+      wait_any(self);
+  }
+
+  void process::kill() noexcept {
+    process *self = this;
+    kill_all(std::span{&self, 1});
+  }
+
+  void process::kill_all(std::span<process * const> procs) noexcept {
+    auto alive = [](process *p) { return p && p->running(); };
+
+    for(process *p : procs)
+      if(alive(p))
+        ::kill(p->target(), SIGTERM);
+    
+    auto deadline = clock::now() + grace_period;
+    while(true) {
+      bool left = false;
+      for(process *p : procs)
+        if(alive(p) && !p->release(WNOHANG))
+          left = true;
+
+      if(!left || clock::now() >= deadline)
+        break;
+      std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+
+    for(process *p : procs) {
+      if(alive(p)) {
+        ::kill(p->target(), SIGKILL);
+        p->release(0);
+      }
+    }
+  }
+
+  //
+  // Reaps the child if it has terminated, or waits for it if no options are
+  // given, and tells whether it did. A child that cannot be waited for is 
+  // given up as well. The group may outlive its leader, so it is killed in
+  // any case.
+  //
+  bool process::release(int options) noexcept {
+    pid_t res = waitpid(_pid, &_status, options);
+    while(res == -1 && errno == EINTR)
+      res = waitpid(_pid, &_status, options);
+
+    if(res == 0)
+      return false;
+
+    if(_group)
+      ::kill(-_pid, SIGKILL);
+    if(_out != -1)
+      close(_out);
+    _out = -1;
+    _pid = -1;
+    return true;
+  }
+
+  size_t process::wait_any(std::span<process * const> procs) {
+    while(true) {
+      std::vector<pollfd> fds;
+      std::vector<size_t> index;
+      std::optional<clock::time_point> deadline;
+      for(size_t i = 0; i < procs.size(); i++) {
+        process *p = procs[i];
+        if(!p || !p->running())
+          continue;
+        
+        if(p->expired()) {
+          p->kill();
+          p->_timed_out = true;
+          return i;
+        }
+
+        fds.push_back(pollfd{p->_out, POLLIN, 0});
+        index.push_back(i);
+        if(p->_deadline)
+          deadline = deadline ? std::min(*deadline, *p->_deadline) 
+                              : *p->_deadline;
+      }
+
+      if(fds.empty())
+        return procs.size();
+
+      int timeout = -1;
+      if(deadline) {
+        auto left = std::chrono::ceil<std::chrono::milliseconds>(
+          *deadline - clock::now()
+        );
+        timeout = int(std::max<long long>(left.count(), 0));
+      }
+
+      if(poll(fds.data(), fds.size(), timeout) == -1) {
+        if(errno == EINTR)
+          continue;
+        system_error("unable to wait for child processes");
+      }
+
+      for(size_t i = 0; i < fds.size(); i++) {
+        if(!fds[i].revents)
+          continue;
+
+        process *p = procs[index[i]];
+        p->drain();
+        if(p->_out == -1) {
+          p->reap();
+          return index[i];
+        }
+      }
+    }
+  }
+
+}
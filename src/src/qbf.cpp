@@ -27,6 +27,19 @@
 #include <black/logic/cnf.hpp>
 #include <black/logic/prettyprint.hpp>
 
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <sstream>
@@ -34,6 +47,8 @@
 
 namespace synth {
 
+  using namespace std::literals;
+
   namespace logic = black::logic;
 
   struct prenex_qbf {
@@ -41,159 +56,291 @@ namespace synth {
     bformula matrix;
   };
 
-  struct flatten_t {
-      
-    qbformula flatten(qbformula f);
+  namespace {
+    //
+    // Variables bound by distinct quantifiers are given distinct names, and 
+    // biconditionals with quantified operands are expanded. Quantifier-free
+    // subformulas are returned as they are, while each occurrence of a 
+    // quantified subformula gets its own copy binding fresh variables, even
+    // if the node is shared, so that no variable is bound twice after 
+    // prenexing.
+    //
+    struct flatten_t {
+        
+      qbformula flatten(qbformula f);
+
+      fresh_gen_t fresh;
+      std::unordered_set<proposition> used;
+    };
 
-    fresh_gen_t fresh;
-    std::unordered_set<proposition> used;
-  };
+    qbformula flatten_t::flatten(qbformula f) {
+      using namespace logic::fragments::QBF;
+
+      if(f.is<bformula>())
+        return f;
+
+      return f.match(
+        [](boolean b) -> qbformula { return b; },
+        [](proposition p) -> qbformula { return p; },
+        [&](negation, auto arg) -> qbformula {
+          return !flatten(arg);
+        },
+        [&](iff, auto left, auto right) -> qbformula {
+          return flatten(implies(left, right) && implies(right, left));
+        },
+        [&](binary b, auto left, auto right) -> qbformula {
+          auto nleft = flatten(left);
+          auto nright = flatten(right);
+          return binary(b.node_type(), nleft, nright);
+        },
+        [&](qbf q, auto vars, auto matrix) -> qbformula {
+          if(vars.empty())
+            return flatten(matrix);
+
+          std::unordered_map<proposition, proposition> map;
+          for(auto p : vars) {
+            if(used.contains(p))
+              map.insert({p, fresh(p)});
+          }
 
-  qbformula flatten_t::flatten(qbformula f) {
-    using namespace logic::fragments::QBF;
+          auto renaming = [&](proposition p) {
+            if(map.contains(p))
+              return map.at(p);
+            return p;
+          };
 
-    return f.match(
-      [](boolean b) { return b; },
-      [](proposition p) { return p; },
-      [&](negation, auto arg) {
-        return !flatten(arg);
-      },
-      [&](binary b, auto left, auto right) {
-        auto nleft = flatten(left);
-        auto nright = flatten(right);
-        return binary(b.node_type(), nleft, nright);
-      },
-      [&](qbf q, auto vars, auto matrix) -> qbformula {
-        if(vars.empty())
-          return flatten(matrix);
-
-        std::unordered_map<proposition, proposition> map;
-        for(auto p : vars) {
-          if(used.contains(p))
-            map.insert({p, fresh(p)});
+          auto new_vars = rename(vars, renaming);
+          auto new_matrix = map.empty() ? matrix : rename(matrix, renaming);
+          used.insert(new_vars.begin(), new_vars.end());
+          return qbf(q.node_type(), new_vars, flatten(new_matrix));
         }
+      );
+    }
+
+    using prefix_t = 
+      std::vector<std::pair<quantifier_t, std::vector<proposition>>>;
+
+    struct prenexed {
+      prefix_t blocks;
+      bformula matrix;
+    };
+
+    quantifier_t dual(quantifier_t t) {
+      if(t == quantifier_t::thereis{})
+        return quantifier_t::foreach{};
+      return quantifier_t::thereis{};
+    }
+
+    prefix_t dual(prefix_t blocks) {
+      for(auto &[quantifier, vars] : blocks)
+        quantifier = dual(quantifier);
+      return blocks;
+    }
 
-        auto renaming = [&](proposition p) {
-          if(map.contains(p))
-            return map.at(p);
-          return p;
-        };
+    // appends a block, merging it with the last one if of the same type
+    void append(prefix_t &blocks, quantifier_t q, std::vector<proposition> vars)
+    {
+      if(vars.empty())
+        return;
 
-        auto new_vars = rename(vars, renaming);
-        auto new_matrix = rename(matrix, renaming);
-        used.insert(vars.begin(), vars.end());
-        return qbf(q.node_type(), new_vars, flatten(new_matrix));
+      if(!blocks.empty() && blocks.back().first == q)
+        blocks.back().second.insert(
+          blocks.back().second.end(), vars.begin(), vars.end()
+        );
+      else
+        blocks.push_back({q, std::move(vars)});
+    }
+
+    //
+    // Interleaves the prefixes of two independent subformulas. When their 
+    // first blocks have different types, the one from the prefix with more 
+    // blocks left goes first, so that the result has as few alternations 
+    // as possible.
+    //
+    prefix_t merge(prefix_t const& a, prefix_t const& b) {
+      prefix_t result;
+      size_t i = 0;
+      size_t j = 0;
+      while(i < a.size() || j < b.size()) {
+        bool from_a = j == b.size() || (i < a.size() && (
+          a[i].first == b[j].first || a.size() - i >= b.size() - j
+        ));
+
+        auto const& [q, vars] = from_a ? a[i++] : b[j++];
+        append(result, q, vars);
       }
-    );
-  }
 
-  qbformula flatten(qbformula f) {
-    return flatten_t{}.flatten(f);
-  }
+      return result;
+    }
 
-  qbformula prenex(qbformula f) {
-    using namespace logic::fragments::QBF;
+    //
+    // Prenexing works on flattened formulas and is memoized on each node, 
+    // so shared subformulas are processed once. Before moving a quantifier 
+    // to the front, the operands of its matrix (seen as a chain of 
+    // conjunctions or disjunctions) that do not mention its variables are 
+    // moved out of its scope (miniscoping), so that their quantifiers can 
+    // be interleaved freely with the others.
+    //
+    struct prenex_t {
+
+      prenexed const& prenex(qbformula f);
+      std::unordered_set<proposition> const& support(qbformula f);
+
+      std::unordered_map<qbformula, prenexed> memo;
+      std::unordered_map<qbformula, std::unordered_set<proposition>> supports;
+    };
 
-    auto dual = [](qbf::type t) {
-      return t.match(
-        [](qbf::type::thereis) { return qbf::type::foreach{}; },
-        [](qbf::type::foreach) { return qbf::type::thereis{}; }
+    std::unordered_set<proposition> const& prenex_t::support(qbformula f) {
+      using namespace logic::fragments::QBF;
+
+      if(auto it = supports.find(f); it != supports.end())
+        return it->second;
+
+      std::unordered_set<proposition> result;
+      auto add = [&](qbformula arg) {
+        auto const& s = support(arg);
+        result.insert(s.begin(), s.end());
+      };
+
+      f.match(
+        [](boolean) { },
+        [&](proposition p) { result.insert(p); },
+        [&](negation, auto arg) { add(arg); },
+        [&](binary, auto left, auto right) {
+          add(left);
+          add(right);
+        },
+        [&](qbf, auto, auto matrix) { add(matrix); }
       );
-    };
 
-    if(f.is<bformula>())
-      return f;
-
-    return f.match(
-      [](boolean b) { return b; },
-      [](proposition p) { return p; },
-      [&](negation, auto arg) {
-        return arg.match(
-          [](boolean b) { return !b; },
-          [](proposition p) { return !p; },
-          [](negation, auto narg) {
-            return prenex(narg);
-          },
-          [](conjunction, auto left, auto right) {
-            return prenex(!left || !right);
-          },
-          [](disjunction, auto left, auto right) {
-            return prenex(!left && !right);
-          },
-          [](implication, auto left, auto right) {
-            return prenex(left && !right);
-          },
-          [](iff, auto left, auto right) {
-            return prenex(!(implies(left, right) && implies(right, left)));
-          },
-          [&](qbf q, auto vars, auto matrix) {
-            return qbf(dual(q.node_type()), vars, prenex(!matrix));
+      return supports.insert({f, std::move(result)}).first->second;
+    }
+
+    prenexed const& prenex_t::prenex(qbformula f) {
+      using namespace logic::fragments::QBF;
+
+      if(auto it = memo.find(f); it != memo.end())
+        return it->second;
+
+      if(auto b = f.to<bformula>(); b)
+        return memo.insert({f, prenexed{{}, *b}}).first->second;
+
+      prenexed result = f.match(
+        // Boolean formulas are handled above
+        [](boolean) -> prenexed { black_unreachable(); },
+        [](proposition) -> prenexed { black_unreachable(); },
+        [&](negation, auto arg) {
+          prenexed const& p = prenex(arg);
+          return prenexed{dual(p.blocks), !p.matrix};
+        },
+        [&](conjunction, auto left, auto right) {
+          prenexed const& l = prenex(left);
+          prenexed const& r = prenex(right);
+          return prenexed{merge(l.blocks, r.blocks), l.matrix && r.matrix};
+        },
+        [&](disjunction, auto left, auto right) {
+          prenexed const& l = prenex(left);
+          prenexed const& r = prenex(right);
+          return prenexed{merge(l.blocks, r.blocks), l.matrix || r.matrix};
+        },
+        [&](implication, auto left, auto right) {
+          prenexed const& l = prenex(left);
+          prenexed const& r = prenex(right);
+          return prenexed{
+            merge(dual(l.blocks), r.blocks), implies(l.matrix, r.matrix)
+          };
+        },
+        // flattening expands biconditionals with quantified operands
+        [](iff) -> prenexed { black_unreachable(); },
+        [&](qbf q, auto vars, qbformula matrix) -> prenexed {
+          auto const& occurring = support(matrix);
+          std::vector<proposition> bound;
+          for(auto p : vars)
+            if(occurring.contains(p))
+              bound.push_back(p);
+
+          if(bound.empty())
+            return prenex(matrix);
+
+          auto mentions = [&](qbformula arg) {
+            auto const& s = support(arg);
+            return std::any_of(bound.begin(), bound.end(), [&](auto p) {
+              return s.contains(p);
+            });
+          };
+
+          bool conj = matrix.is<conjunction>();
+          std::vector<qbformula> inside;
+          std::vector<qbformula> outside;
+          std::vector<qbformula> stack = {matrix};
+          while(!stack.empty()) {
+            qbformula arg = stack.back();
+            stack.pop_back();
+
+            if(auto c = arg.to<conjunction>(); c && conj) {
+              stack.push_back(c->right());
+              stack.push_back(c->left());
+            } else if(auto d = arg.to<disjunction>(); d && !conj) {
+              stack.push_back(d->right());
+              stack.push_back(d->left());
+            } else if(mentions(arg))
+              inside.push_back(arg);
+            else
+              outside.push_back(arg);
           }
-        );
-      },
-      [](conjunction, qbformula left, qbformula right) -> qbformula { 
-        auto pleft = prenex(left);
-        auto pright = prenex(right);
-
-        if(auto ql = pleft.to<qbf>(); ql) {
-          return qbf(
-            ql->node_type(), ql->variables(), prenex(ql->matrix() && pright)
-          );
-        }
-        if(auto qr = pright.to<qbf>(); qr) {
-          return qbf(
-            qr->node_type(), qr->variables(), prenex(pleft && qr->matrix())
-          );
-        }
 
-        return pleft && pright;
-      },
-      [](disjunction, qbformula left, qbformula right) -> qbformula { 
-        auto pleft = prenex(left);
-        auto pright = prenex(right);
+          std::optional<prenexed> joined;
+          auto join = [&](prenexed const& p) {
+            if(!joined) {
+              joined = p;
+              return;
+            }
+            joined->blocks = merge(joined->blocks, p.blocks);
+            joined->matrix = conj 
+              ? joined->matrix && p.matrix : joined->matrix || p.matrix;
+          };
+
+          qbformula scope = matrix;
+          if(!outside.empty()) {
+            scope = inside[0];
+            for(size_t i = 1; i < inside.size(); i++)
+              scope = conj ? scope && inside[i] : scope || inside[i];
+          }
 
-        if(auto ql = pleft.to<qbf>(); ql) {
-          return qbf(
-            ql->node_type(), ql->variables(), prenex(ql->matrix() || pright)
-          );
-        }
-        if(auto qr = pright.to<qbf>(); qr) {
-          return qbf(
-            qr->node_type(), qr->variables(), prenex(pleft || qr->matrix())
-          );
-        }
+          prenexed const& body = prenex(scope);
+          prenexed scoped{{}, body.matrix};
+          append(scoped.blocks, q.node_type(), bound);
+          for(auto const& [quantifier, block] : body.blocks)
+            append(scoped.blocks, quantifier, block);
+          join(scoped);
 
-        return pleft || pright;
-      },
-      [&](implication, qbformula left, qbformula right) -> qbformula {
-        auto pleft = prenex(left);
-        auto pright = prenex(right);
+          for(qbformula arg : outside)
+            join(prenex(arg));
 
-        if(auto ql = pleft.to<qbf>(); ql) {
-          return qbf(
-            dual(ql->node_type()), ql->variables(), 
-            prenex(implies(ql->matrix(), pright))
-          );
-        }
-        if(auto qr = pright.to<qbf>(); qr) {
-          return qbf(
-            qr->node_type(), qr->variables(), 
-            prenex(implies(pleft, qr->matrix()))
-          );
+          return *joined;
         }
+      );
 
-        return implies(pleft, pright);
-      },
-      [](iff, auto left, auto right) {
-        return prenex(implies(left, right) && implies(right, left));
-      },
-      [](qbf q, auto vars, auto matrix) {
-        return qbf(q.node_type(), vars, prenex(matrix));
-      }
-    );
+      return memo.insert({f, std::move(result)}).first->second;
+    }
+  }
+
+  qbformula flatten(qbformula f) {
+    return flatten_t{}.flatten(f);
   }
 
+  qbformula prenex(qbformula f) {
+    using namespace logic::fragments::QBF;
+
+    prenex_t p;
+    prenexed const& result = p.prenex(f);
 
+    qbformula r = result.matrix;
+    for(auto it = result.blocks.rbegin(); it != result.blocks.rend(); ++it)
+      r = qbf(it->first, it->second, r);
+
+    return r;
+  }
 
   static prenex_qbf extract_prenex(qbformula f) 
   {
@@ -231,52 +378,311 @@ namespace synth {
     return str.str();
   }
 
-  qdimacs clausify(qbformula f) {
+  qdimacs clausify(qbformula f, clausifier_t clausifier) {
 
     prenex_qbf qbformula = extract_prenex(f);
 
-    black::cnf cnf = black::to_cnf(qbformula.matrix);
+    prenex_cnf result;
+    for(auto block : qbformula.blocks)
+      result.blocks.push_back({
+        block.node_type(), 
+        std::vector<proposition>(
+          block.variables().begin(), block.variables().end()
+        )
+      });
 
-    std::unordered_map<var_t, proposition> props;
-    std::unordered_map<proposition, var_t> vars;
+    result.matrix.push_back(
+      std::make_shared<black::cnf const>(to_cnf(qbformula.matrix, clausifier))
+    );
 
-    // clauses
-    std::vector<clause> clauses;
+    return clausify(result);
+  }
 
-    var_t next_var = 1;
-    for(auto cl : cnf.clauses) {
-      std::vector<lit_t> literals;
-      for(auto [sign, prop] : cl.literals) {
-        var_t var;
-        if(auto it = vars.find(prop); it != vars.end()) 
-          var = it->second;
-        else {
-          var = next_var++;
-          props.insert({var, prop});
-          vars.insert({prop, var});
+  //
+  // Appends the clauses of the given pieces to the list, numbering the
+  // variables not seen before.
+  //
+  static void number(
+    std::vector<std::shared_ptr<black::cnf const>> const& pieces,
+    std::vector<std::optional<proposition>> &props,
+    std::unordered_map<proposition, var_t> &vars,
+    clause_list &clauses
+  ) {
+    size_t n_clauses = 0;
+    size_t n_literals = 0;
+    for(auto const& piece : pieces) {
+      n_clauses += piece->clauses.size();
+      for(auto const& cl : piece->clauses)
+        n_literals += cl.literals.size();
+    }
+
+    clauses.reserve(n_clauses, n_literals);
+
+    for(auto const& piece : pieces) {
+      for(auto const& cl : piece->clauses) {
+        for(auto [sign, prop] : cl.literals) {
+          auto [it, fresh] = vars.try_emplace(prop, var_t(props.size()));
+          if(fresh) {
+            if(props.size() > size_t(std::numeric_limits<lit_t>::max()))
+              throw std::runtime_error(
+                "too many variables for the QDIMACS encoding"
+              );
+            props.push_back(prop);
+          }
+
+          lit_t lit = lit_t(it->second);
+          clauses.add(sign ? -lit : lit);
         }
+        clauses.close();
+      }
+    }
+  }
+
+  std::string to_string(clausifier_t clausifier) {
+    switch(clausifier) {
+      case clausifier_t::tseitin:
+        return "tseitin";
+      case clausifier_t::polarity:
+        return "polarity";
+    }
+    black_unreachable();
+  }
+
+  std::optional<clausifier_t> to_clausifier(std::string const& name) {
+    if(name == "tseitin")
+      return clausifier_t::tseitin;
+    if(name == "polarity")
+      return clausifier_t::polarity;
+    return {};
+  }
+
+  namespace {
+    //
+    // The variable standing for a subformula is named after the subformula
+    // itself, so occurrences of the same subformula share it, also across 
+    // CNFs obtained separately. `encode(f, pol)` returns a literal x such 
+    // that x implies f if `pol` has the `positive` bit, and f implies x if it
+    // has the `negative` bit. Each clause emitted is implied by x <-> f, so 
+    // CNFs defining the same variable in different directions can be 
+    // conjoined.
+    //
+    struct polarity_encoder {
+      enum : uint8_t {
+        positive = 1,
+        negative = 2
+      };
+
+      static uint8_t flip(uint8_t pol) {
+        return uint8_t(((pol & positive) << 1) | ((pol & negative) >> 1));
+      }
+
+      template<typename Op>
+      static std::vector<bformula> operands(bformula f);
+
+      void assert_true(bformula f);
+      black::literal encode(bformula f, uint8_t pol);
+
+      void add(std::vector<black::literal> literals) {
+        black::clause cl;
+        cl.literals = std::move(literals);
+        result.clauses.push_back(std::move(cl));
+      }
+
+      black::cnf result;
+      std::unordered_map<bformula, uint8_t> encoded;
+    };
+
+    // the leaves of the chain of `Op` nodes rooted at f, from left to right
+    template<typename Op>
+    std::vector<bformula> polarity_encoder::operands(bformula f) {
+      std::vector<bformula> result;
+      std::vector<bformula> stack = {f};
+      while(!stack.empty()) {
+        bformula g = stack.back();
+        stack.pop_back();
+        
+        if(auto op = g.to<Op>(); op) {
+          stack.push_back(op->right());
+          stack.push_back(op->left());
+        } else
+          result.push_back(g);
+      }
+
+      return result;
+    }
+
+    black::literal neg(black::literal lit) {
+      return black::literal{!lit.sign, lit.prop};
+    }
+
+    //
+    // Top-level conjunctions and disjunctions need no variable.
+    //
+    void polarity_encoder::assert_true(bformula f) {
+      for(bformula c : operands<logic::conjunction<Bool>>(f)) {
+        c.match(
+          [&](logic::boolean b) {
+            if(!b.value())
+              add({});
+          },
+          [&](logic::disjunction<Bool>) {
+            std::vector<black::literal> cl;
+            for(bformula d : operands<logic::disjunction<Bool>>(c))
+              cl.push_back(encode(d, positive));
+            add(std::move(cl));
+          },
+          [&](logic::implication<Bool>, auto left, auto right) {
+            add({neg(encode(left, negative)), encode(right, positive)});
+          },
+          [&](otherwise) {
+            add({encode(c, positive)});
+          }
+        );
+      }
+    }
+
+    black::literal polarity_encoder::encode(bformula f, uint8_t pol) {
+      if(auto p = f.to<proposition>(); p)
+        return black::literal{false, *p};
+      if(auto n = f.to<logic::negation<Bool>>(); n)
+        return neg(encode(n->argument(), flip(pol)));
+
+      black::literal t{false, f.sigma()->proposition(f)};
+
+      uint8_t &done = encoded[f];
+      uint8_t todo = uint8_t(pol & ~done);
+      done |= pol;
+
+      bool pos = todo & positive;
+      bool nega = todo & negative;
+      if(!pos && !nega)
+        return t;
+
+      f.match(
+        [&](logic::boolean b) {
+          if(pos && !b.value())
+            add({neg(t)});
+          if(nega && b.value())
+            add({t});
+        },
+        [&](logic::conjunction<Bool>) {
+          auto args = operands<logic::conjunction<Bool>>(f);
+          std::vector<black::literal> lits;
+          for(bformula arg : args)
+            lits.push_back(encode(arg, todo));
+          
+          if(pos)
+            for(auto lit : lits)
+              add({neg(t), lit});
+          if(nega) {
+            std::vector<black::literal> cl = {t};
+            for(auto lit : lits)
+              cl.push_back(neg(lit));
+            add(std::move(cl));
+          }
+        },
+        [&](logic::disjunction<Bool>) {
+          auto args = operands<logic::disjunction<Bool>>(f);
+          std::vector<black::literal> lits;
+          for(bformula arg : args)
+            lits.push_back(encode(arg, todo));
+          
+          if(pos) {
+            std::vector<black::literal> cl = {neg(t)};
+            cl.insert(cl.end(), lits.begin(), lits.end());
+            add(std::move(cl));
+          }
+          if(nega)
+            for(auto lit : lits)
+              add({t, neg(lit)});
+        },
+        [&](logic::implication<Bool>, auto left, auto right) {
+          black::literal l = encode(left, flip(todo));
+          black::literal r = encode(right, todo);
+          
+          if(pos)
+            add({neg(t), neg(l), r});
+          if(nega) {
+            add({t, l});
+            add({t, neg(r)});
+          }
+        },
+        [&](logic::iff<Bool>, auto left, auto right) {
+          black::literal l = encode(left, positive | negative);
+          black::literal r = encode(right, positive | negative);
+          
+          if(pos) {
+            add({neg(t), neg(l), r});
+            add({neg(t), l, neg(r)});
+          }
+          if(nega) {
+            add({t, l, r});
+            add({t, neg(l), neg(r)});
+          }
+        },
+        [](otherwise) { black_unreachable(); }
+      );
 
-        literals.push_back(sign ? -lit_t{var} : lit_t{var});
+      return t;
+    }
+  }
+
+  black::cnf to_cnf(bformula f, clausifier_t clausifier) {
+    switch(clausifier) {
+      case clausifier_t::tseitin:
+        return black::to_cnf(f);
+      case clausifier_t::polarity: {
+        polarity_encoder enc;
+        enc.assert_true(f);
+        return std::move(enc.result);
+      }
+    }
+    black_unreachable();
+  }
+
+  void unroll(clause_template const& t, size_t n, clause_list &out) {
+    if(n * t.width + t.n_state >= size_t(std::numeric_limits<lit_t>::max()))
+      throw std::runtime_error("too many variables for the QDIMACS encoding");
+
+    out.reserve(n * t.clauses.size(), n * t.clauses.n_literals());
+    for(size_t k = 0; k < n; k++) {
+      lit_t shift = lit_t(k * t.width);
+      for(clause cl : t.clauses) {
+        for(lit_t lit : cl)
+          out.add(lit > 0 ? lit + shift : lit - shift);
+        out.close();
       }
-      clauses.push_back(clause{literals});
     }
+  }
+
+  qdimacs clausify(prenex_cnf const& f) {
+
+    std::vector<std::optional<proposition>> props = {std::nullopt};
+    std::unordered_map<proposition, var_t> vars;
+
+    // clauses
+    clause_list clauses;
+    number(f.matrix, props, vars, clauses);
+
+    var_t n_vars = var_t(props.size() - 1);
 
     std::vector<qdimacs_block> blocks;
-    std::unordered_set<var_t> declared_vars;
+    std::vector<bool> declared(props.size(), false);
 
     // quantifiers
-    for(auto block : qbformula.blocks) {
+    for(auto const& [quantifier, variables] : f.blocks) {
       
       std::vector<var_t> block_vars;
-      for(auto p : block.variables()) {
-        if(!vars.contains(p)) 
+      for(auto p : variables) {
+        auto it = vars.find(p);
+        if(it == vars.end()) 
           continue;
 
-        declared_vars.insert(vars[p]);
-        block_vars.push_back(vars[p]);
+        declared[it->second] = true;
+        block_vars.push_back(it->second);
       }
 
-      if(block.node_type() == quantifier_t::thereis{})
+      if(quantifier == quantifier_t::thereis{})
         blocks.push_back(qdimacs_block{qdimacs_block::existential, block_vars});
       else
         blocks.push_back(qdimacs_block{qdimacs_block::universal, block_vars});
@@ -284,52 +690,134 @@ namespace synth {
     }
 
     // quantifiers for Tseitin variables
-    std::unordered_set<var_t> last;
-    for(auto cl : cnf.clauses) {
-      for(auto [sign, prop] : cl.literals) {
-        if(!vars.contains(prop))
-          continue;
-        var_t var = vars[prop];
-        if(!declared_vars.contains(var)) {
-          last.insert(var);
-        }
-      }
-    }
+    std::vector<var_t> last;
+    for(var_t var = 1; var <= n_vars; ++var)
+      if(!declared[var])
+        last.push_back(var);
+    
     if(!last.empty())
       blocks.push_back(qdimacs_block{
-        qdimacs_block::existential, std::vector(last.begin(), last.end())
+        qdimacs_block::existential, std::move(last)
       });
 
-    return qdimacs{next_var - 1, blocks, clauses, props, vars};
+    return qdimacs{
+      n_vars, std::move(blocks), std::move(clauses), 
+      std::move(props), std::move(vars), {}
+    };
   }
 
-  std::string to_string(qdimacs qd) {
-    std::stringstream str;
+  namespace {
+    //
+    // Serialization goes through a fixed buffer which is handed to the sink
+    // whenever it fills up, so no memory is allocated along the way.
+    //
+    template<typename Sink>
+    class output_buffer {
+    public:
+      explicit output_buffer(Sink sink) : _sink{std::move(sink)} { }
+
+      void put(char c) {
+        reserve(1);
+        _buf[_used++] = c;
+      }
 
-    // header
-    str << "p cnf " << qd.n_vars << " " << qd.clauses.size() << "\n";
+      void put(std::string_view s) {
+        reserve(s.size());
+        s.copy(_buf.data() + _used, s.size());
+        _used += s.size();
+      }
 
-    // quantifiers
-    for(auto block : qd.blocks) {
-      if(block.type == qdimacs_block::existential)
-        str << "e ";
-      else
-        str << "a ";
+      template<std::integral T>
+      void put(T value) {
+        reserve(24);
+        auto res = 
+          std::to_chars(_buf.data() + _used, _buf.data() + _buf.size(), value);
+        _used = size_t(res.ptr - _buf.data());
+      }
 
-      for(var_t var : block.variables) 
-        str << var << " ";
-      str << "0\n";
-    }
+      size_t flush() {
+        _sink(std::string_view{_buf.data(), _used});
+        _total += _used;
+        _used = 0;
+        return _total;
+      }
 
-    // clauses
-    for(clause cl : qd.clauses) {
-      for(lit_t lit : cl.literals) {
-        str << lit << " ";
+    private:
+      void reserve(size_t n) {
+        if(_used + n > _buf.size())
+          flush();
       }
-      str << "0\n";
+
+      Sink _sink;
+      std::array<char, 1 << 16> _buf;
+      size_t _used = 0;
+      size_t _total = 0;
+    };
+
+    template<typename Sink>
+    size_t write(qdimacs const& qd, Sink sink) {
+      output_buffer<Sink> out{std::move(sink)};
+
+      // header
+      out.put("p cnf ");
+      out.put(qd.n_vars);
+      out.put(' ');
+      out.put(qd.clauses.size());
+      out.put('\n');
+
+      // quantifiers
+      for(auto const& block : qd.blocks) {
+        out.put(block.type == qdimacs_block::existential ? "e " : "a ");
+        for(var_t var : block.variables) {
+          out.put(var);
+          out.put(' ');
+        }
+        out.put("0\n");
+      }
+
+      for(auto const& [var, deps] : qd.dependencies) {
+        out.put("d ");
+        out.put(var);
+        out.put(' ');
+        for(var_t dep : deps) {
+          out.put(dep);
+          out.put(' ');
+        }
+        out.put("0\n");
+      }
+
+      // clauses
+      for(clause cl : qd.clauses) {
+        for(lit_t lit : cl) {
+          out.put(lit);
+          out.put(' ');
+        }
+        out.put("0\n");
+      }
+
+      return out.flush();
     }
+  }
 
-    return str.str();
+  size_t write(qdimacs const& qd, int fd) {
+    return write(qd, [fd](std::string_view data) {
+      while(!data.empty()) {
+        ssize_t n = ::write(fd, data.data(), data.size());
+        if(n < 0 && errno == EINTR)
+          continue;
+        if(n < 0)
+          throw std::runtime_error(
+            "unable to write QDIMACS output: "s + strerror(errno)
+          );
+        data.remove_prefix(size_t(n));
+      }
+    });
+  }
+
+  std::string to_string(qdimacs const& qd) {
+    std::string str;
+    write(qd, [&](std::string_view data) { str += data; });
+    return str;
   }
 
 }
@@ -0,0 +1,88 @@
+//
+// Synthetico - Pure-past LTL synthesizer based on BLACK
+//
+// (C) 2023 Nicola Gigante
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#include "synthetico/synthetico.hpp"
+
+#include <array>
+#include <cstdlib>
+#include <stdexcept>
+#include <string_view>
+
+namespace synth {
+
+  static constexpr std::array<std::string_view, 4> sat_backends = {
+    "cmsat", "z3", "cvc5", "mathsat"
+  };
+
+  bool sat_solver::is_available() {
+    for(auto name : sat_backends)
+      if(black::sat::solver::backend_exists(name))
+        return true;
+    return false;
+  }
+
+  sat_solver::sat_solver(logic::alphabet &sigma) : _sigma{&sigma} {
+    for(auto name : sat_backends) {
+      if(black::sat::solver::backend_exists(name)) {
+        _solver = black::sat::solver::backend(name);
+        return;
+      }
+    }
+
+    throw std::runtime_error("no SAT backend is available in BLACK");
+  }
+
+  bformula sat_solver::literal(lit_t lit) const {
+    proposition p = _sigma->proposition(sat_var_t{var_t(std::abs(lit))});
+    if(lit < 0)
+      return !p;
+    return p;
+  }
+
+  void sat_solver::add(clause cl) {
+    _solver->assert_formula(big_or(*_sigma, cl, [&](lit_t lit) {
+      return literal(lit);
+    }));
+  }
+
+  void sat_solver::add(clause_list const& clauses) {
+    for(clause cl : clauses)
+      add(cl);
+  }
+
+  black::tribool sat_solver::solve(std::span<lit_t const> assumptions) {
+    if(assumptions.empty())
+      return _solver->is_sat();
+
+    return _solver->is_sat_with(big_and(*_sigma, assumptions, [&](lit_t lit) {
+      return literal(lit);
+    }));
+  }
+
+  bool sat_solver::value(var_t var) const {
+    return _solver->value(_sigma->proposition(sat_var_t{var})) == true;
+  }
+
+}